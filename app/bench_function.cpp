@@ -1,3 +1,4 @@
+#include <map>
 #include <nano/stats.h>
 #include <nano/table.h>
 #include <nano/logger.h>
@@ -30,6 +31,20 @@ static void eval_func(const function_t& function, table_t& table)
         gx += g.template lpNorm<Eigen::Infinity>();
     }, trials).count();
 
+    // evaluate a batch of points at once (e.g. multi-start, line-search brackets)
+    const tensor_size_t points = 16;
+    const matrix_t X = matrix_t::Zero(points, dims);
+    vector_t f(points);
+    matrix_t G(points, dims);
+
+    volatile scalar_t bx = 0;
+    const auto batch_time = measure<nanoseconds_t>([&] ()
+    {
+        function.vgrad_batch(map_matrix(X.data(), points, dims), map_vector(f.data(), points),
+            map_matrix(G.data(), points, dims));
+        bx += G.template lpNorm<Eigen::Infinity>();
+    }, trials).count() / points;
+
     scalar_t grad_accuracy = 0;
     for (size_t i = 0; i < trials; ++ i)
     {
@@ -37,7 +52,7 @@ static void eval_func(const function_t& function, table_t& table)
     }
 
     auto& row = table.append();
-    row << function.name() << fval_time << grad_time
+    row << function.name() << fval_time << grad_time << batch_time
         << nano::precision(12) << (grad_accuracy / static_cast<scalar_t>(trials));
 }
 
@@ -48,6 +63,8 @@ static int unsafe_main(int argc, const char* argv[])
     cmdline.add("", "min-dims",     "minimum number of dimensions for each test function (if feasible)", "1024");
     cmdline.add("", "max-dims",     "maximum number of dimensions for each test function (if feasible)", "1024");
     cmdline.add("", "functions",    "use this regex to select the functions to benchmark", ".+");
+    cmdline.add("", "save",         "save the measurements to this CSV file (e.g. to use as a baseline later)");
+    cmdline.add("", "baseline",     "compare the timings with the measurements previously saved in this CSV file");
 
     cmdline.process(argc, argv);
 
@@ -62,8 +79,32 @@ static int unsafe_main(int argc, const char* argv[])
     const auto max_dims = cmdline.get<tensor_size_t>("max-dims");
     const auto functions = std::regex(cmdline.get<string_t>("functions"));
 
+    // load the baseline measurements (if any) indexed by the function's name
+    std::map<string_t, std::vector<std::pair<size_t, scalar_t>>> baseline;
+    if (cmdline.has("baseline"))
+    {
+        table_t btable;
+        critical(
+            btable.load(cmdline.get<string_t>("baseline")),
+            strcat("load baseline measurements from <", cmdline.get<string_t>("baseline"), ">"));
+
+        for (size_t r = 0; r < btable.rows(); ++ r)
+        {
+            const auto& row = btable.row(r);
+            if (row.type() == row_t::mode::data)
+            {
+                baseline[row.data(0)] = row.collect<scalar_t>();
+            }
+        }
+    }
+
     table_t table;
-    table.header() << "function" << "f(x)[ns]" << "f(x,g)[ns]" << "grad accuracy";
+    auto& header = table.header();
+    header << "function" << "f(x)[ns]" << "f(x,g)[ns]" << "f(X,G)[ns/point]" << "grad accuracy";
+    if (!baseline.empty())
+    {
+        header << "f(x) speedup" << "f(x,g) speedup" << "f(X,G) speedup";
+    }
     table.delim();
 
     tensor_size_t prev_size = min_dims;
@@ -75,10 +116,43 @@ static int unsafe_main(int argc, const char* argv[])
             prev_size = function->size();
         }
         eval_func(*function, table);
+
+        if (!baseline.empty())
+        {
+            // NB: the speedups are relative to the timings of the same function in the baseline
+            auto& row = table.row(table.rows() - 1);
+            const auto it = baseline.find(function->name());
+            const auto values = row.collect<scalar_t>();
+            for (size_t col = 1; col <= 3; ++ col)
+            {
+                const auto speedup = [&] ()
+                {
+                    if (it != baseline.end())
+                    {
+                        const auto op = [&] (const auto& value) { return value.first == col; };
+                        const auto bit = std::find_if(it->second.begin(), it->second.end(), op);
+                        const auto cit = std::find_if(values.begin(), values.end(), op);
+                        if (bit != it->second.end() && cit != values.end() && cit->second > 0)
+                        {
+                            return bit->second / cit->second;
+                        }
+                    }
+                    return std::numeric_limits<scalar_t>::quiet_NaN();
+                }();
+                row << nano::precision(2) << speedup;
+            }
+        }
     }
 
     std::cout << table;
 
+    if (cmdline.has("save"))
+    {
+        critical(
+            table.save(cmdline.get<string_t>("save")),
+            strcat("save measurements to <", cmdline.get<string_t>("save"), ">"));
+    }
+
     // OK
     return EXIT_SUCCESS;
 }
@@ -30,7 +30,8 @@ struct solver_stat_t
     stats_t     m_fcalls;           ///< #function value calls
     stats_t     m_gcalls;           ///< #gradient calls
     stats_t     m_costs;            ///< computation cost as a function of function value and gradient calls
-    int64_t     m_milliseconds{0};  ///< total number of milliseconds
+    int64_t     m_milliseconds{0};  ///< total number of milliseconds (wall-clock)
+    int64_t     m_nanoseconds{0};   ///< total number of nanoseconds summed over the runs
 };
 
 using solver_config_stats_t = std::map<
@@ -55,7 +56,8 @@ static void show_table(const string_t& table_name, const solver_config_stats_t&
         << "#fcalls"
         << "#gcalls"
         << "cost"
-        << "[ms]";
+        << "[ms]"
+        << "[ns/iter]";
     table.delim();
 
     for (const auto& it : stats)
@@ -74,7 +76,8 @@ static void show_table(const string_t& table_name, const solver_config_stats_t&
             << static_cast<size_t>(stat.m_fcalls.avg())
             << static_cast<size_t>(stat.m_gcalls.avg())
             << static_cast<size_t>(stat.m_costs.avg())
-            << stat.m_milliseconds;
+            << stat.m_milliseconds
+            << static_cast<size_t>(static_cast<scalar_t>(stat.m_nanoseconds) / std::max(stat.m_iters.sum1(), 1.0));
         }
     }
 
@@ -134,11 +137,7 @@ static void check_solver(const function_t& function, const rsolver_t& solver,
 {
     const auto timer = nano::timer_t{};
 
-    std::vector<solver_state_t> states(x0s.size());
-    loopi(x0s.size(), [&] (const size_t i, const size_t)
-    {
-        states[i] = solver->minimize(function, x0s[i]);
-    });
+    const auto states = solver->minimize_multistart(function, x0s);
 
     const auto milliseconds = timer.milliseconds().count();
 
@@ -154,14 +153,19 @@ static void check_solver(const function_t& function, const rsolver_t& solver,
         }
     }
 
-    const auto key = std::make_tuple(solver_id, solver->lsearch0_id(), solver->lsearchk_id());
+    const auto key = solver->has_lsearch() ?
+        std::make_tuple(solver_id, solver->lsearch0_id(), solver->lsearchk_id()) :
+        std::make_tuple(solver_id, string_t("-"), string_t("-"));
     auto& fstat = fstats[key];
     auto& gstat = gstats[key];
 
+    // NB: each run is timed individually, so that the cost per iteration does not depend on the number of workers
     for (const auto& state : states)
     {
         fstat.update(state);
         gstat.update(state);
+        fstat.m_nanoseconds += state.m_nanoseconds;
+        gstat.m_nanoseconds += state.m_nanoseconds;
     }
     fstat.m_milliseconds += milliseconds;
     gstat.m_milliseconds += milliseconds;
@@ -210,6 +214,7 @@ static int unsafe_main(int argc, const char* argv[])
     cmdline.add("", "lsearch0",         "use this regex to select the line-search initialization methods");
     cmdline.add("", "lsearchk",         "use this regex to select the line-search strategies");
     cmdline.add("", "log-failures",     "log the optimization trajectory for the runs that fail");
+    cmdline.add("", "quasi-parallel",   "update the quasi-Newton approximations in parallel starting from this number of dimensions");
 
     cmdline.process(argc, argv);
 
@@ -251,12 +256,20 @@ static int unsafe_main(int argc, const char* argv[])
         if (!lsearchk.empty()) { solver->lsearchk(lsearchk); }
         if (cmdline.has("c1")) { solver->c1(cmdline.get<scalar_t>("c1")); }
         if (cmdline.has("c2")) { solver->c2(cmdline.get<scalar_t>("c2")); }
+        if (cmdline.has("quasi-parallel")) { solver->config(to_json("parallel", cmdline.get<tensor_size_t>("quasi-parallel"))); }
 
         solvers.emplace_back(solver_id, std::move(solver));
     };
 
     for (const auto& id : solver_t::all().ids(sregex))
     {
+        // NB: the line-search configurations are irrelevant for some solvers (e.g. trust-region methods)
+        if (!solver_t::all().get(id)->has_lsearch())
+        {
+            add_solver(id, "", "");
+            continue;
+        }
+
         for (const auto& lsearch0 : lsearch0s)
         {
             for (const auto& lsearchk : lsearchks)
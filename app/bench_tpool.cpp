@@ -1,3 +1,4 @@
+#include <functional>
 #include <nano/table.h>
 #include <nano/tpool.h>
 #include <nano/logger.h>
@@ -65,15 +66,22 @@ static scalar_t reduce_st(const matrix_t& targets, const matrix_t& outputs)
 }
 
 template <typename toperator>
-static scalar_t reduce_mt(const matrix_t& targets, const matrix_t& outputs)
+static scalar_t reduce_mt(tpool_t& pool, const tpool_reduction reduction, const matrix_t& targets, const matrix_t& outputs)
 {
-    vector_t values = vector_t::Zero(tpool_t::size());
-    nano::loopi(targets.rows(), [&] (const tensor_size_t i, const tensor_size_t t)
+    const auto map = [&] (const tensor_size_t begin, const tensor_size_t end)
     {
-        values(t) += sti<toperator>(i, targets, outputs);
-    });
+        scalar_t value = 0;
+        for (auto i = begin; i < end; ++ i)
+        {
+            value += sti<toperator>(i, targets, outputs);
+        }
+        return value;
+    };
 
-    return values.sum() / static_cast<scalar_t>(targets.rows());
+    const auto value = nano::loop_reduce(pool, targets.rows(), tensor_size_t(256), scalar_t(0),
+        map, std::plus<scalar_t>(), reduction);
+
+    return value / static_cast<scalar_t>(targets.rows());
 }
 
 #if defined(_OPENMP)
@@ -105,7 +113,8 @@ static bool close(const scalar_t v1, const scalar_t v2, const char* name, const
 }
 
 template <typename toperator>
-static bool evaluate(const tensor_size_t min_size, const tensor_size_t max_size, table_t& table)
+static bool evaluate(const tensor_size_t min_size, const tensor_size_t max_size,
+    const std::vector<std::unique_ptr<tpool_t>>& pools, table_t& table)
 {
     std::vector<scalar_t> single_deltas;
     std::vector<scalar_t> single_values;
@@ -134,20 +143,24 @@ static bool evaluate(const tensor_size_t min_size, const tensor_size_t max_size,
         single_outputs.push_back(outputs);
     }
 
-    // multi-threaded (using the thread pool)
-    auto& row2 = table.append();
-    row2 << strcat("reduce-", toperator::name()) << strcat("tpool(x", tpool_t::size(), ")");
-    for (size_t i = 0; i < single_deltas.size(); ++ i)
+    // multi-threaded (using the thread pool with various scheduling and reduction methods)
+    for (const auto& pool : pools)
+    for (const auto reduction : enum_values<tpool_reduction>())
     {
-        const auto deltaST = single_deltas[i];
-        const auto valueST = single_values[i];
-        const auto& targets = single_targets[i];
-        const auto& outputs = single_outputs[i];
-
-        scalar_t valueMT;
-        const auto deltaMT = measure<nanoseconds_t>([&] { valueMT = reduce_mt<toperator>(targets, outputs); }, 16);
-        row2 << precision(2) << deltaST / static_cast<double>(deltaMT.count());
-        if (!close(valueST, valueMT, "tpool", epsilon1<scalar_t>())) { return false; }
+        auto& row2 = table.append();
+        row2 << strcat("reduce-", toperator::name()) << strcat("tpool(x", pool->workers(), ",", pool->mode(), ",", reduction, ")");
+        for (size_t i = 0; i < single_deltas.size(); ++ i)
+        {
+            const auto deltaST = single_deltas[i];
+            const auto valueST = single_values[i];
+            const auto& targets = single_targets[i];
+            const auto& outputs = single_outputs[i];
+
+            scalar_t valueMT;
+            const auto deltaMT = measure<nanoseconds_t>([&] { valueMT = reduce_mt<toperator>(*pool, reduction, targets, outputs); }, 16);
+            row2 << precision(2) << deltaST / static_cast<double>(deltaMT.count());
+            if (!close(valueST, valueMT, "tpool", epsilon1<scalar_t>())) { return false; }
+        }
     }
 
 #ifdef _OPENMP
@@ -172,12 +185,145 @@ static bool evaluate(const tensor_size_t min_size, const tensor_size_t max_size,
     return true;
 }
 
+static scalar_t uneven_op(const tensor_size_t i, const tensor_size_t size)
+{
+    // NB: the cost of an iteration increases linearly with its index
+    scalar_t value = 0;
+    for (tensor_size_t k = 0, iterations = 1 + (32 * i) / size; k < iterations; ++ k)
+    {
+        value += std::sin(static_cast<scalar_t>(i + k));
+    }
+    return value;
+}
+
+static void evaluate_schedules(const tensor_size_t min_size, const tensor_size_t max_size,
+    const std::vector<std::unique_ptr<tpool_t>>& pools, const std::vector<tpool_schedule>& schedules, table_t& table)
+{
+    const auto chunk = tensor_size_t(64);
+
+    std::vector<scalar_t> single_deltas;
+    for (tensor_size_t size = min_size; size <= max_size; size *= 2)
+    {
+        vector_t values(size);
+        const auto delta = measure<nanoseconds_t>([&] ()
+        {
+            for (tensor_size_t i = 0; i < size; ++ i)
+            {
+                values(i) = uneven_op(i, size);
+            }
+        }, 16);
+
+        single_deltas.push_back(static_cast<scalar_t>(delta.count()));
+    }
+
+    auto& row1 = table.append();
+    row1 << "uneven-speedup" << "single";
+    for (size_t i = 0; i < single_deltas.size(); ++ i)
+    {
+        row1 << "1.00";
+    }
+
+    // multi-threaded: speedup and load imbalance (maximum over average busy time per task)
+    std::vector<std::vector<scalar_t>> imbalances;
+    for (const auto& pool : pools)
+    for (const auto schedule : schedules)
+    {
+        const auto method = strcat("tpool(x", pool->workers(), ",", pool->mode(), ",", schedule, ")");
+
+        auto& row2 = table.append();
+        row2 << "uneven-speedup" << method;
+
+        imbalances.emplace_back();
+        size_t i = 0;
+        for (tensor_size_t size = min_size; size <= max_size; size *= 2, ++ i)
+        {
+            vector_t values(size);
+            const auto run = [&] (std::vector<int64_t>* busy)
+            {
+                nano::loopr(*pool, size, chunk, [&] (const tensor_size_t begin, const tensor_size_t end, const tensor_size_t tnum)
+                {
+                    const nano::timer_t timer;
+                    for (auto k = begin; k < end; ++ k)
+                    {
+                        values(k) = uneven_op(k, size);
+                    }
+                    if (busy != nullptr)
+                    {
+                        (*busy)[static_cast<size_t>(tnum)] += timer.nanoseconds().count();
+                    }
+                }, schedule);
+            };
+
+            const auto delta = measure<nanoseconds_t>([&] { run(nullptr); }, 16);
+            row2 << precision(2) << single_deltas[i] / static_cast<scalar_t>(delta.count());
+
+            std::vector<int64_t> busy(pool->workers(), 0);
+            run(&busy);
+
+            const auto max_busy = static_cast<scalar_t>(*std::max_element(busy.begin(), busy.end()));
+            const auto avg_busy = static_cast<scalar_t>(std::accumulate(busy.begin(), busy.end(), int64_t(0))) /
+                static_cast<scalar_t>(busy.size());
+            imbalances.back().push_back(max_busy / std::max(avg_busy, scalar_t(1)));
+        }
+    }
+
+    table.delim();
+
+    auto it = imbalances.begin();
+    for (const auto& pool : pools)
+    for (const auto schedule : schedules)
+    {
+        auto& row3 = table.append();
+        row3 << "uneven-imbalance" << strcat("tpool(x", pool->workers(), ",", pool->mode(), ",", schedule, ")");
+        for (const auto imbalance : *(it ++))
+        {
+            row3 << precision(2) << imbalance;
+        }
+    }
+}
+
+static void evaluate_overhead(const std::vector<tpool_mode>& modes, table_t& table)
+{
+    // NB: measure the per-call overhead of an empty parallel loop for various idle strategies
+    for (const auto mode : modes)
+    {
+        for (const auto* strategy : {"park", "spin", "hot"})
+        {
+            auto config = tpool_config_t::from_env();
+            config.m_mode = mode;
+            config.m_spin = (string_t(strategy) == "park") ? size_t(0) : std::max(config.m_spin, size_t(1));
+
+            tpool_t pool(config);
+
+            std::unique_ptr<tpool_hot_loop_t> hot_loop;
+            if (string_t(strategy) == "hot")
+            {
+                hot_loop = std::make_unique<tpool_hot_loop_t>(pool);
+            }
+
+            auto& row = table.append();
+            row << "loopi-empty" << strcat("tpool(x", pool.workers(), ",", mode, ",", strategy, ")");
+            for (const auto size : {size_t(1), pool.workers(), size_t(1024)})
+            {
+                const auto delta = measure<nanoseconds_t>([&] ()
+                {
+                    nano::loopi(pool, size, [] (const size_t, const size_t) {});
+                }, 16);
+
+                row << delta.count();
+            }
+        }
+    }
+}
+
 static int unsafe_main(int argc, const char *argv[])
 {
     // parse the command line
     cmdline_t cmdline("benchmark thread pool");
     cmdline.add("", "min-size",     "minimum problem size (in kilo)", 1);
     cmdline.add("", "max-size",     "maximum problem size (in kilo)", 1024);
+    cmdline.add("", "tpool-mode",   "regex to select the thread pool scheduling methods to compare", ".+");
+    cmdline.add("", "tpool-schedule","regex to select the loop scheduling policies to compare", ".+");
 
     cmdline.process(argc, argv);
 
@@ -201,16 +347,38 @@ static int unsafe_main(int argc, const char *argv[])
     }
     table.delim();
 
+    // thread pools to compare (NB: the size and the affinity can be set using the environment variables)
+    std::vector<std::unique_ptr<tpool_t>> pools;
+    for (const auto mode : enum_values<tpool_mode>(std::regex(cmdline.get<string_t>("tpool-mode"))))
+    {
+        auto config = tpool_config_t::from_env();
+        config.m_mode = mode;
+        pools.push_back(std::make_unique<tpool_t>(config));
+    }
+
     // benchmark for different problem sizes and processing chunk sizes
-    if (!evaluate<exp_t>(cmd_min_size, cmd_max_size, table)) { return EXIT_FAILURE; }
+    if (!evaluate<exp_t>(cmd_min_size, cmd_max_size, pools, table)) { return EXIT_FAILURE; }
     table.delim();
-    if (!evaluate<log_t>(cmd_min_size, cmd_max_size, table)) { return EXIT_FAILURE; }
+    if (!evaluate<log_t>(cmd_min_size, cmd_max_size, pools, table)) { return EXIT_FAILURE; }
     table.delim();
-    if (!evaluate<mse_t>(cmd_min_size, cmd_max_size, table)) { return EXIT_FAILURE; }
+    if (!evaluate<mse_t>(cmd_min_size, cmd_max_size, pools, table)) { return EXIT_FAILURE; }
+    table.delim();
+
+    // benchmark the loop scheduling policies for iterations of uneven cost
+    const auto schedules = enum_values<tpool_schedule>(std::regex(cmdline.get<string_t>("tpool-schedule")));
+    evaluate_schedules(cmd_min_size, cmd_max_size, pools, schedules, table);
 
     // print results
     std::cout << table;
 
+    // benchmark the per-call overhead of the thread pool
+    table_t overhead;
+    overhead.header() << "problem" << "method" << "size=1 [ns]" << "size=workers [ns]" << "size=1K [ns]";
+    overhead.delim();
+    evaluate_overhead(enum_values<tpool_mode>(std::regex(cmdline.get<string_t>("tpool-mode"))), overhead);
+
+    std::cout << overhead;
+
     // OK
     return EXIT_SUCCESS;
 }
@@ -2,6 +2,7 @@
 #include <nano/loss.h>
 #include <nano/table.h>
 #include <nano/logger.h>
+#include <nano/stoch.h>
 #include <nano/solver.h>
 #include <nano/cmdline.h>
 #include <nano/dataset.h>
@@ -45,6 +46,7 @@ static int unsafe_main(int argc, const char* argv[])
     cmdline.add("", "lsearch0",             "regex to select line-search initialization methods", ".+");
     cmdline.add("", "lsearchk",             "regex to select line-search strategies", ".+");
     cmdline.add("", "solver",               "regex to select numerical optimization methods", ".+");
+    cmdline.add("", "stoch",                "regex to select stochastic optimization methods", ".+");
     cmdline.add("", "loss",                 "regex to select loss functions", ".+");
     cmdline.add("", "dataset",              "regex to select datasets", ".+");
     cmdline.add("", "as-table",             "display the selected objects in a table");
@@ -57,6 +59,7 @@ static int unsafe_main(int argc, const char* argv[])
     const auto has_lsearch0 = cmdline.has("lsearch0");
     const auto has_lsearchk = cmdline.has("lsearchk");
     const auto has_solver = cmdline.has("solver");
+    const auto has_stoch = cmdline.has("stoch");
     const auto has_loss = cmdline.has("loss");
     const auto has_dataset = cmdline.has("dataset");
     const auto has_as_table = cmdline.has("as-table");
@@ -73,6 +76,7 @@ static int unsafe_main(int argc, const char* argv[])
     if (!has_lsearch0 &&
         !has_lsearchk &&
         !has_solver &&
+        !has_stoch &&
         !has_loss &&
         !has_dataset &&
         !has_version &&
@@ -95,6 +99,10 @@ static int unsafe_main(int argc, const char* argv[])
     {
         print("solver", solver_t::all(), cmdline.get<string_t>("solver"), has_as_table, has_as_json);
     }
+    if (has_stoch)
+    {
+        print("stoch", stoch_solver_t::all(), cmdline.get<string_t>("stoch"), has_as_table, has_as_json);
+    }
     if (has_loss)
     {
         print("loss", loss_t::all(), cmdline.get<string_t>("loss"), has_as_table, has_as_json);
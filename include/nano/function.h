@@ -76,11 +76,81 @@ namespace nano
         ///
         virtual scalar_t vgrad(const vector_t& x, vector_t* gx = nullptr) const = 0;
 
+        ///
+        /// \brief compute the function values (and the gradients if not empty) of a batch of points:
+        ///     f(i) = f(X.row(i)) and G.row(i) = grad(f)(X.row(i)).
+        ///
+        /// NB: the default implementation evaluates the points one by one,
+        ///     but it can be overridden to evaluate them together using matrix operations.
+        ///
+        virtual void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const;
+
+        ///
+        /// \brief compute the function value and the directional derivative along the given direction:
+        ///     f(x) and dg = grad(f)(x).dot(d), without computing the full gradient.
+        ///
+        /// NB: this is optional and it is useful only if cheaper than computing the full gradient
+        ///     (e.g. for the line-search trials), otherwise the default implementation returns false
+        ///     and the gradient should be computed with vgrad.
+        ///
+        virtual bool vdir(const vector_t& x, const vector_t& d, scalar_t& fx, scalar_t& dg) const;
+
+        ///
+        /// \brief compute the coefficients of the restriction of the function to the line x + t * d:
+        ///     phi(t) = f(x + t * d), so that the function value and its derivative along the line
+        ///     can be evaluated cheaply (e.g. without matrix-vector products) by line_vgrad.
+        ///
+        /// NB: this is optional (e.g. for the exact line-search), so the default implementation returns false.
+        /// NB: the coefficients are by default those of the polynomial phi(t) - phi(0) = sum(c_k * t^(k+1), k=0,K),
+        ///     but the functions can use any other representation by overriding line_vgrad as well.
+        ///
+        virtual bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const;
+
+        ///
+        /// \brief compute the change of the function value along the line phi(t) - phi(0)
+        ///     (and its derivative phi'(t)) given the coefficients computed by line_coeffs.
+        ///
+        virtual scalar_t line_vgrad(const vector_t& coeffs, scalar_t t, scalar_t& dphi) const;
+
+        ///
+        /// \brief compute the Hessian-vector product: Hv = Hessian(f)(x) * v.
+        ///
+        /// NB: the analytic product is used if available (see hvprod_analytic),
+        ///     otherwise it is approximated with central finite differences of gradients (see hvprod_approx).
+        ///
+        void hvprod(const vector_t& x, const vector_t& v, vector_t& Hv) const;
+
+        ///
+        /// \brief compute analytically the Hessian-vector product (e.g. for quadratic functions).
+        ///
+        /// NB: this is optional and the default implementation returns false.
+        ///
+        virtual bool hvprod_analytic(const vector_t& x, const vector_t& v, vector_t& Hv) const;
+
+        ///
+        /// \brief approximate the Hessian-vector product with central finite differences of gradients
+        ///     (two gradient evaluations).
+        ///
+        void hvprod_approx(const vector_t& x, const vector_t& v, vector_t& Hv) const;
+
         ///
         /// \brief compute the gradient accuracy (given vs. finite difference approximation)
         ///
+        /// NB: the coordinates are perturbed in parallel using the thread pool (2 * size() function calls),
+        ///     except for small problems, so the function value must be thread-safe to compute.
+        ///
         scalar_t grad_accuracy(const vector_t& x) const;
 
+        ///
+        /// \brief compute the gradient accuracy along the given number of random directions
+        ///     (directional derivative vs. finite difference approximation).
+        ///
+        /// NB: this requires only 2 * directions function calls, so it is useful to check large problems.
+        /// NB: the directions are generated from the given seed, so that the check is reproducible.
+        /// NB: the directions are checked in parallel using the thread pool (as above).
+        ///
+        scalar_t grad_accuracy(const vector_t& x, const tensor_size_t directions, uint32_t seed = 42) const;
+
     private:
 
         // attributes
@@ -27,6 +27,37 @@ namespace nano
             return (x.array().square() * m_bias.array()).sum();
         }
 
+        bool vdir(const vector_t& x, const vector_t& d, scalar_t& fx, scalar_t& dg) const override
+        {
+            fx = (x.array().square() * m_bias.array()).sum();
+            dg = 2 * (x.array() * d.array() * m_bias.array()).sum();
+            return true;
+        }
+
+        bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const override
+        {
+            coeffs.resize(2);
+            coeffs(0) = 2 * (x.array() * d.array() * m_bias.array()).sum();
+            coeffs(1) = (d.array().square() * m_bias.array()).sum();
+            return true;
+        }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            if (G.size() > 0)
+            {
+                G.array() = 2 * (X.array().rowwise() * m_bias.transpose().array());
+            }
+
+            f.array() = (X.array().square().rowwise() * m_bias.transpose().array()).rowwise().sum();
+        }
+
+        bool hvprod_analytic(const vector_t&, const vector_t& v, vector_t& Hv) const override
+        {
+            Hv = 2 * v.array() * m_bias.array();
+            return true;
+        }
+
     private:
 
         // attributes
@@ -25,5 +25,17 @@ namespace nano
 
             return std::log1p(x.dot(x));
         }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            const vector_t u = X.rowwise().squaredNorm();
+
+            if (G.size() > 0)
+            {
+                G.array() = X.array().colwise() * (2 / (1 + u.array()));
+            }
+
+            f.array() = u.array().log1p();
+        }
     };
 }
@@ -39,6 +39,28 @@ namespace nano
                 (2 * xsegm1.array().square() - xsegm0.array()).square()).sum();
         }
 
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            const auto n = size();
+            const auto xsegm0 = X.leftCols(n - 1).array();
+            const auto xsegm1 = X.rightCols(n - 1).array();
+
+            if (G.size() > 0)
+            {
+                const auto weight = (2 * (2 * xsegm1.square() - xsegm0)).rowwise() *
+                    m_bias.segment(1, n - 1).transpose().array();
+
+                G.setZero();
+                G.col(0).array() = 2 * (X.col(0).array() - 1);
+                G.rightCols(n - 1).array() += weight * 4 * xsegm1;
+                G.leftCols(n - 1).array() -= weight;
+            }
+
+            f.array() = (X.col(0).array() - 1).square() +
+                ((2 * xsegm1.square() - xsegm0).square().rowwise() *
+                m_bias.segment(1, n - 1).transpose().array()).rowwise().sum();
+        }
+
     private:
 
         // attributes
@@ -27,5 +27,17 @@ namespace nano
 
             return fx;
         }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            const vector_t fx = (1 + X.rowwise().squaredNorm().array() / scalar_t(size())).exp();
+
+            if (G.size() > 0)
+            {
+                G.array() = X.array().colwise() * (2 * fx.array() / scalar_t(size()));
+            }
+
+            f = fx;
+        }
     };
 }
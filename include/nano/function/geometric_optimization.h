@@ -34,6 +34,41 @@ namespace nano
             return (m_a + m_A * x).array().exp().sum();
         }
 
+        bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const override
+        {
+            // NB: phi(t) = sum(i, exp(u_i + t * v_i)), with u = alpha + A * x and v = A * d
+            const auto n = m_a.size();
+            coeffs.resize(2 * n);
+            coeffs.segment(0, n).noalias() = m_a + m_A * x;
+            coeffs.segment(n, n).noalias() = m_A * d;
+            return true;
+        }
+
+        scalar_t line_vgrad(const vector_t& coeffs, const scalar_t t, scalar_t& dphi) const override
+        {
+            const auto n = m_a.size();
+            const auto u = coeffs.segment(0, n).array();
+            const auto v = coeffs.segment(n, n).array();
+
+            dphi = (v * (u + t * v).exp()).sum();
+            return (u.exp() * (t * v).unaryExpr([] (const scalar_t value) { return std::expm1(value); })).sum();
+        }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            // NB: all exponential terms of all points at once: exp(alpha_i + a_i.dot(x_k))
+            matrix_t E = X * m_A.transpose();
+            E.rowwise() += m_a.transpose();
+            E.array() = E.array().exp();
+
+            if (G.size() > 0)
+            {
+                G.noalias() = E * m_A;
+            }
+
+            f = E.rowwise().sum();
+        }
+
     private:
 
         // attributes
@@ -18,29 +18,45 @@ namespace nano
         }
 
         scalar_t vgrad(const vector_t& x, vector_t* gx) const override
+        {
+            return eval(x, gx);
+        }
+
+    private:
+
+        template <typename txvector, typename tgvector>
+        scalar_t eval(const txvector& x, tgvector* gx) const
         {
             scalar_t fx = 0;
-            for (tensor_size_t i = 0, i4 = 0; i < size() / 4; ++ i, i4 += 4)
+            if (gx)
             {
-                fx += nano::square(x(i4 + 0) + x(i4 + 1) * 10);
-                fx += nano::square(x(i4 + 2) - x(i4 + 3)) * 5;
-                fx += nano::quartic(x(i4 + 1) - x(i4 + 2) * 2);
-                fx += nano::quartic(x(i4 + 0) - x(i4 + 3)) * 10;
-            }
+                // NB: a single pass computing the function value and the gradient of each group of 4
+                for (tensor_size_t i4 = 0; i4 < size(); i4 += 4)
+                {
+                    const auto x01 = x(i4 + 0) + x(i4 + 1) * 10;
+                    const auto x23 = x(i4 + 2) - x(i4 + 3);
+                    const auto x12 = x(i4 + 1) - x(i4 + 2) * 2;
+                    const auto x03 = x(i4 + 0) - x(i4 + 3);
 
-            if (gx)
+                    const auto x12_3 = nano::cube(x12);
+                    const auto x03_3 = nano::cube(x03);
+
+                    fx += x01 * x01 + x23 * x23 * 5 + x12_3 * x12 + x03_3 * x03 * 10;
+
+                    (*gx)(i4 + 0) = x01 * 2 + x03_3 * 40;
+                    (*gx)(i4 + 1) = x01 * 20 + x12_3 * 4;
+                    (*gx)(i4 + 2) = x23 * 10 - x12_3 * 8;
+                    (*gx)(i4 + 3) = - x23 * 10 - x03_3 * 40;
+                }
+            }
+            else
             {
-                for (tensor_size_t i = 0, i4 = 0; i < size() / 4; ++ i, i4 += 4)
+                for (tensor_size_t i4 = 0; i4 < size(); i4 += 4)
                 {
-                    const auto gfx0 = (x(i4 + 0) + x(i4 + 1) * 10) * 2;
-                    const auto gfx1 = (x(i4 + 2) - x(i4 + 3)) * 5 * 2;
-                    const auto gfx2 = nano::cube(x(i4 + 1) - x(i4 + 2) * 2) * 4;
-                    const auto gfx3 = nano::cube(x(i4 + 0) - x(i4 + 3)) * 10 * 4;
-
-                    (*gx)(i4 + 0) = gfx0 + gfx3;
-                    (*gx)(i4 + 1) = gfx0 * 10 + gfx2;
-                    (*gx)(i4 + 2) = gfx1 - 2 * gfx2;
-                    (*gx)(i4 + 3) = - gfx1 - gfx3;
+                    fx += nano::square(x(i4 + 0) + x(i4 + 1) * 10);
+                    fx += nano::square(x(i4 + 2) - x(i4 + 3)) * 5;
+                    fx += nano::quartic(x(i4 + 1) - x(i4 + 2) * 2);
+                    fx += nano::quartic(x(i4 + 0) - x(i4 + 3)) * 10;
                 }
             }
 
@@ -27,6 +27,16 @@ namespace nano
             return (x.array().square() - m_bias.array()).square().sum();
         }
 
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            if (G.size() > 0)
+            {
+                G.array() = 4 * (X.array().square().rowwise() - m_bias.transpose().array()) * X.array();
+            }
+
+            f.array() = (X.array().square().rowwise() - m_bias.transpose().array()).square().rowwise().sum();
+        }
+
     private:
 
         // attributes
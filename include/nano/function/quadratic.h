@@ -30,6 +30,36 @@ namespace nano
             return x.dot(m_a + (m_A * x) / scalar_t(2));
         }
 
+        bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const override
+        {
+            // NB: A is symmetric, so grad(f)(x).dot(d) = a.dot(d) + x.dot(A * d)
+            const vector_t Ad = m_A * d;
+
+            coeffs.resize(2);
+            coeffs(0) = m_a.dot(d) + x.dot(Ad);
+            coeffs(1) = d.dot(Ad) / scalar_t(2);
+            return true;
+        }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            // NB: A is symmetric, so A * x_k = (x_k' * A)'
+            matrix_t AX = X * m_A;
+
+            f.array() = (X.array() * ((AX / scalar_t(2)).rowwise() + m_a.transpose()).array()).rowwise().sum();
+
+            if (G.size() > 0)
+            {
+                G = AX.rowwise() + m_a.transpose();
+            }
+        }
+
+        bool hvprod_analytic(const vector_t&, const vector_t& v, vector_t& Hv) const override
+        {
+            Hv.noalias() = m_A * v;
+            return true;
+        }
+
     private:
 
         // attributes
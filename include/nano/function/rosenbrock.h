@@ -19,26 +19,27 @@ namespace nano
 
         scalar_t vgrad(const vector_t& x, vector_t* gx) const override
         {
-            const auto ct = scalar_t(100);
+            return eval(x, gx);
+        }
 
-            scalar_t fx = 0;
-            for (tensor_size_t i = 0; i + 1 < size(); ++ i)
-            {
-                fx += ct * nano::square(x(i + 1) - x(i) * x(i)) + nano::square(x(i) - 1);
-            }
+    private:
+
+        template <typename txvector, typename tgvector>
+        scalar_t eval(const txvector& x, tgvector* gx) const
+        {
+            const auto ct = scalar_t(100);
+            const auto n = size();
+            const auto x0 = x.segment(0, n - 1).array();
+            const auto x1 = x.segment(1, n - 1).array();
 
             if (gx)
             {
-                (*gx).setZero();
-                for (tensor_size_t i = 0; i + 1 < size(); ++ i)
-                {
-                    (*gx)(i) += 2 * (x(i) - 1);
-                    (*gx)(i) += ct * 2 * (x(i + 1) - x(i) * x(i)) * (- 2 * x(i));
-                    (*gx)(i + 1) += ct * 2 * (x(i + 1) - x(i) * x(i));
-                }
+                (*gx)(n - 1) = 0;
+                gx->segment(0, n - 1).array() = 2 * (x0 - 1) - ct * 4 * (x1 - x0.square()) * x0;
+                gx->segment(1, n - 1).array() += ct * 2 * (x1 - x0.square());
             }
 
-            return fx;
+            return (ct * (x1 - x0.square()).square() + (x0 - 1).square()).sum();
         }
     };
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <iterator>
 #include <nano/numeric.h>
 #include <nano/function.h>
 
@@ -8,6 +10,9 @@ namespace nano
     ///
     /// \brief rotated hyper-ellipsoid function: see https://www.sfu.ca/~ssurjano/rothyp.html.
     ///
+    /// NB: the batches of points use the default implementation (see function_t::vgrad_batch),
+    ///     as the prefix sums over the columns of the row-major points are strided and thus slower.
+    ///
     class function_rotated_ellipsoid_t final : public function_t
     {
     public:
@@ -19,26 +24,160 @@ namespace nano
 
         scalar_t vgrad(const vector_t& x, vector_t* gx) const override
         {
-            scalar_t fx = 0, fi = 0;
-            for (auto i = 0; i < size(); i ++)
+            return eval(x, gx);
+        }
+
+        bool vdir(const vector_t& x, const vector_t& d, scalar_t& fx, scalar_t& dg) const override
+        {
+            // NB: the directional derivative is twice the dot product of the prefix sums of x and d,
+            //  so it is computed in the same pass as the function value without the gradient (see eval).
+            //  With Lx, Ld the local prefix sums and Ox, Od the offsets of each block:
+            //      sum(Px * Pd) = sum(Lx * Ld) + Od * sum(Lx) + Ox * sum(Ld) + count * Ox * Od.
+            const auto n = size();
+            const auto b = n / 4;
+
+            std::array<scalar_t, 4> lx{{0, 0, 0, 0}}, ld{{0, 0, 0, 0}};
+            std::array<scalar_t, 4> slx{{0, 0, 0, 0}}, sld{{0, 0, 0, 0}}, slxx{{0, 0, 0, 0}}, slxd{{0, 0, 0, 0}};
+
+            const auto accumulate = [&] (const tensor_size_t k, const tensor_size_t i)
             {
-                fi += x(i);
-                fx += nano::square(fi);
-                if (gx)
+                lx[k] += x(i);
+                ld[k] += d(i);
+                slx[k] += lx[k];
+                sld[k] += ld[k];
+                slxx[k] += lx[k] * lx[k];
+                slxd[k] += lx[k] * ld[k];
+            };
+
+            for (tensor_size_t i = 0; i < b; ++ i)
+            {
+                for (tensor_size_t k = 0; k < 4; ++ k)
                 {
-                    (*gx)(i) = 2 * fi;
+                    accumulate(k, k * b + i);
                 }
             }
+            for (tensor_size_t i = 4 * b; i < n; ++ i)
+            {
+                accumulate(3, i);
+            }
+
+            fx = dg = 0;
+            scalar_t ox = 0, od = 0;
+            for (tensor_size_t k = 0; k < 4; ++ k)
+            {
+                const auto count = static_cast<scalar_t>(k < 3 ? b : n - 3 * b);
+                fx += slxx[k] + 2 * ox * slx[k] + count * ox * ox;
+                dg += 2 * (slxd[k] + od * slx[k] + ox * sld[k] + count * ox * od);
+                ox += lx[k];
+                od += ld[k];
+            }
+
+            return true;
+        }
+
+        bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const override
+        {
+            // NB: the function is a quadratic form, so phi(t) - phi(0) = t * grad(f)(x).dot(d) + t^2 * f(d)
+            scalar_t fx, dg;
+            vdir(x, d, fx, dg);
+
+            coeffs.resize(2);
+            coeffs(0) = dg;
+            coeffs(1) = eval(d, static_cast<vector_t*>(nullptr));
+            return true;
+        }
+
+        bool hvprod_analytic(const vector_t&, const vector_t& v, vector_t& Hv) const override
+        {
+            // NB: the Hessian is 2 * L' * L, with L the lower triangular matrix of ones (prefix sums)
+            Hv.resize(size());
+            cumsum(v.data(), Hv.data(), size());
+            cumsum(std::make_reverse_iterator(Hv.data() + size()), std::make_reverse_iterator(Hv.data() + size()), size());
+            Hv.array() *= 2;
+            return true;
+        }
+
+    private:
+
+        template <typename txvector, typename tgvector>
+        scalar_t eval(const txvector& x, tgvector* gx) const
+        {
+            // NB: the prefix sums are computed on 4 blocks at once to break the dependency chain of the additions,
+            //  so that the function value is (with L the local prefix sums and O the block's offset):
+            //      sum(P^2) = sum(L^2) + 2 * O * sum(L) + count * O^2 for each block.
+            const auto n = size();
+            const auto b = n / 4;
 
+            scalar_t fx = 0;
             if (gx)
             {
-                for (auto i = size() - 2; i >= 0; i --)
+                cumsum(x.data(), gx->data(), n);
+                fx = gx->squaredNorm();
+
+                // NB: the gradient is twice the suffix sums of the prefix sums
+                cumsum(std::make_reverse_iterator(gx->data() + n), std::make_reverse_iterator(gx->data() + n), n);
+                gx->array() *= 2;
+            }
+            else
+            {
+                std::array<scalar_t, 4> sl{{0, 0, 0, 0}}, sl1{{0, 0, 0, 0}}, sl2{{0, 0, 0, 0}};
+                for (tensor_size_t i = 0; i < b; ++ i)
+                {
+                    for (tensor_size_t k = 0; k < 4; ++ k)
+                    {
+                        sl[k] += x(k * b + i);
+                        sl1[k] += sl[k];
+                        sl2[k] += sl[k] * sl[k];
+                    }
+                }
+                for (tensor_size_t i = 4 * b; i < n; ++ i)
                 {
-                    (*gx)(i) += (*gx)(i + 1);
+                    sl[3] += x(i);
+                    sl1[3] += sl[3];
+                    sl2[3] += sl[3] * sl[3];
+                }
+
+                scalar_t offset = 0;
+                for (tensor_size_t k = 0; k < 4; ++ k)
+                {
+                    const auto count = static_cast<scalar_t>(k < 3 ? b : n - 3 * b);
+                    fx += sl2[k] + 2 * offset * sl1[k] + count * offset * offset;
+                    offset += sl[k];
                 }
             }
 
             return fx;
         }
+
+        template <typename tinput, typename toutput>
+        static void cumsum(tinput input, toutput output, const tensor_size_t n)
+        {
+            const auto b = n / 4;
+
+            std::array<scalar_t, 4> sums{{0, 0, 0, 0}};
+            for (tensor_size_t i = 0; i < b; ++ i)
+            {
+                for (tensor_size_t k = 0; k < 4; ++ k)
+                {
+                    sums[k] += input[k * b + i];
+                    output[k * b + i] = sums[k];
+                }
+            }
+            for (tensor_size_t i = 4 * b; i < n; ++ i)
+            {
+                sums[3] += input[i];
+                output[i] = sums[3];
+            }
+
+            scalar_t offset = 0;
+            for (tensor_size_t k = 1; k < 4; ++ k)
+            {
+                offset += sums[k - 1];
+                for (tensor_size_t i = k * b, end = (k < 3) ? (k + 1) * b : n; i < end; ++ i)
+                {
+                    output[i] += offset;
+                }
+            }
+        }
     };
 }
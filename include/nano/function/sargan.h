@@ -28,5 +28,17 @@ namespace nano
 
             return scalar_t(0.6) * x2sum + scalar_t(0.4) * nano::square(x2sum);
         }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            const vector_t x2sum = X.rowwise().squaredNorm();
+
+            if (G.size() > 0)
+            {
+                G.array() = X.array().colwise() * (scalar_t(1.2) + scalar_t(1.6) * x2sum.array());
+            }
+
+            f.array() = scalar_t(0.6) * x2sum.array() + scalar_t(0.4) * x2sum.array().square();
+        }
     };
 }
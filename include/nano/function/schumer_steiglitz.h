@@ -25,5 +25,15 @@ namespace nano
 
             return x.array().square().square().sum();
         }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            if (G.size() > 0)
+            {
+                G.array() = 4 * X.array().cube();
+            }
+
+            f = X.array().square().square().rowwise().sum();
+        }
     };
 }
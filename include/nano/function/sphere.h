@@ -25,5 +25,36 @@ namespace nano
 
             return x.dot(x);
         }
+
+        bool vdir(const vector_t& x, const vector_t& d, scalar_t& fx, scalar_t& dg) const override
+        {
+            fx = x.dot(x);
+            dg = 2 * x.dot(d);
+            return true;
+        }
+
+        bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const override
+        {
+            coeffs.resize(2);
+            coeffs(0) = 2 * x.dot(d);
+            coeffs(1) = d.dot(d);
+            return true;
+        }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            if (G.size() > 0)
+            {
+                G.noalias() = 2 * X;
+            }
+
+            f = X.rowwise().squaredNorm();
+        }
+
+        bool hvprod_analytic(const vector_t&, const vector_t& v, vector_t& Hv) const override
+        {
+            Hv.noalias() = 2 * v;
+            return true;
+        }
     };
 }
@@ -25,5 +25,15 @@ namespace nano
 
             return (x.array().square().square() - 16 * x.array().square() + 5 * x.array()).sum();
         }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            if (G.size() > 0)
+            {
+                G.array() = 4 * X.array().cube() - 32 * X.array() + 5;
+            }
+
+            f = (X.array().square().square() - 16 * X.array().square() + 5 * X.array()).rowwise().sum();
+        }
     };
 }
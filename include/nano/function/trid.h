@@ -28,5 +28,28 @@ namespace nano
             return (x.array() - 1).square().sum() -
                    (x.segment(0, size() - 1).array() * x.segment(1, size() - 1).array()).sum();
         }
+
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            const auto n = size();
+
+            if (G.size() > 0)
+            {
+                G.array() = 2 * (X.array() - 1);
+                G.rightCols(n - 1) -= X.leftCols(n - 1);
+                G.leftCols(n - 1) -= X.rightCols(n - 1);
+            }
+
+            f = (X.array() - 1).square().rowwise().sum() -
+                (X.leftCols(n - 1).array() * X.rightCols(n - 1).array()).rowwise().sum();
+        }
+
+        bool hvprod_analytic(const vector_t&, const vector_t& v, vector_t& Hv) const override
+        {
+            Hv = 2 * v;
+            Hv.segment(1, size() - 1) -= v.segment(0, size() - 1);
+            Hv.segment(0, size() - 1) -= v.segment(1, size() - 1);
+            return true;
+        }
     };
 }
@@ -32,6 +32,20 @@ namespace nano
             return u + nano::square(v) + nano::quartic(v);
         }
 
+        void vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const override
+        {
+            const vector_t u = X.rowwise().squaredNorm();
+            const vector_t v = X * m_bias;
+
+            if (G.size() > 0)
+            {
+                G = 2 * X;
+                G.noalias() += (2 * v.array() + 4 * v.array().cube()).matrix() * m_bias.transpose();
+            }
+
+            f.array() = u.array() + v.array().square() + v.array().square().square();
+        }
+
     private:
 
         // attributes
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <nano/loss.h>
+#include <nano/stoch.h>
+#include <nano/dataset.h>
+
+namespace nano
+{
+    ///
+    /// \brief empirical risk of a linear model on the samples of a dataset's fold:
+    ///     f(W, b) = 1/N * sum(loss(target_i, W * input_i + b), i=1,N) + lambda/2 * |W|^2.
+    ///
+    /// NB: the parameters are stored as [W (#outputs x #inputs, row-major), b (#outputs)].
+    /// NB: the missing (non-finite) input feature values are replaced with zero.
+    /// NB: the gradient state of a sample consists of only #outputs scalars (e.g. a scalar for a single output)
+    ///     which makes the variance reduced stochastic solvers (e.g. SAGA) memory efficient.
+    /// NB: the inputs and the targets are copied once (and again after each shuffling)
+    ///     so that the minibatches are contiguous blocks of samples.
+    ///
+    class NANO_PUBLIC linear_function_t final : public stoch_function_t
+    {
+    public:
+
+        using stoch_function_t::vgrad;
+
+        ///
+        /// \brief constructor
+        ///
+        linear_function_t(dataset_t&, const fold_t&, const loss_t&, scalar_t lambda = 0);
+
+        ///
+        /// \brief compute the function value (and gradient if provided) on all samples
+        ///
+        scalar_t vgrad(const vector_t& x, vector_t* gx = nullptr) const override;
+
+        ///
+        /// \brief compute the function value and the directional derivative on all samples:
+        ///     the outputs and their change along the direction are computed together
+        ///     in a single pass over the inputs (instead of two for the gradient).
+        ///
+        bool vdir(const vector_t& x, const vector_t& d, scalar_t& fx, scalar_t& dg) const override;
+
+        ///
+        /// \brief compute the restriction of the function to the line x + t * d:
+        ///     the outputs and their change along the direction for all samples, so that
+        ///     phi(t) is evaluated with only the loss values (without the products with the inputs).
+        ///
+        bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const override;
+        scalar_t line_vgrad(const vector_t& coeffs, scalar_t t, scalar_t& dphi) const override;
+
+        ///
+        /// \brief compute the function value (and gradient if provided) of the [begin, end) minibatch of samples
+        ///
+        scalar_t vgrad(const vector_t& x, tensor_size_t begin, tensor_size_t end,
+            vector_t* gx = nullptr) const override;
+
+        ///
+        /// \brief number of samples
+        ///
+        tensor_size_t samples() const override { return m_inputs.rows(); }
+
+        ///
+        /// \brief the compact per-sample gradient state is the loss gradient wrt the outputs:
+        ///     grad(f_i)(W, b) = [s_i * input_i^T, s_i] + [lambda * W, 0].
+        ///
+        tensor_size_t ssize() const override { return osize(); }
+        scalar_t sgrad_i(const vector_t& x, tensor_size_t i, vector_t& s) const override;
+        void expand_i(tensor_size_t i, const vector_t& s, scalar_t alpha, vector_t& g) const override;
+        void rgrad(const vector_t& x, vector_t& g) const override;
+
+        ///
+        /// \brief randomly shuffle the samples of the dataset's fold
+        ///
+        void shuffle() override;
+
+        ///
+        /// \brief access functions
+        ///
+        auto lambda() const { return m_lambda; }
+        tensor_size_t isize() const { return m_inputs.cols(); }
+        tensor_size_t osize() const { return m_targets.cols(); }
+
+    private:
+
+        void load();
+
+        // attributes
+        dataset_t&      m_dataset;          ///<
+        fold_t          m_fold;             ///< the samples to use
+        const loss_t&   m_loss;             ///<
+        scalar_t        m_lambda{0};        ///< L2-regularization factor
+        matrix_t        m_inputs;           ///< (#samples, #inputs)
+        matrix_t        m_targets;          ///< (#samples, #outputs)
+    };
+}
@@ -35,6 +35,23 @@ namespace nano
             return m_lsearchk->get(state, t0);
         }
 
+        ///
+        /// \brief compute the step length starting from state0 and write the accepted step into the given state
+        ///
+        /// NB: the buffers of the given state are reused (no allocation if they have the same size as state0),
+        ///     so the solvers can swap the previous and the current states instead of copying them.
+        /// NB: the step length of state0 is reset to zero after estimating the initial step length.
+        ///
+        bool get(solver_state_t& state0, solver_state_t& state) const
+        {
+            assert(m_lsearch0);
+            assert(m_lsearchk);
+
+            const auto t0 = m_lsearch0->get(state0);
+            state0.t = 0;
+            return m_lsearchk->get(state0, state, t0);
+        }
+
     private:
 
         // attributes
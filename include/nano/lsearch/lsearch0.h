@@ -36,6 +36,14 @@ namespace nano
         ///
         static lsearch0_factory_t& all();
 
+        ///
+        /// \brief returns a copy of this object (with the same configuration and history)
+        ///
+        /// NB: this is used by the solvers to create cheaply a new line-search object for each minimization
+        ///     (without the factory and the JSON configuration round-trip) from their configured but unused prototype.
+        ///
+        virtual rlsearch0_t clone() const = 0;
+
         ///
         /// \brief returns the initial step length given the current state
         /// NB: may keep track of the previous states
@@ -66,6 +74,16 @@ namespace nano
             }
         }
 
+        ///
+        /// \brief evaluate the function value at the given step length along the current descent direction
+        ///     using the given buffer for the trial point
+        ///
+        static scalar_t value(const solver_state_t& state, const scalar_t t, vector_t& x)
+        {
+            x = state.x + t * state.d;
+            return state.function->vgrad(x);
+        }
+
     private:
 
         // attributes
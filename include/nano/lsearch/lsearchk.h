@@ -36,11 +36,25 @@ namespace nano
         ///
         static lsearchk_factory_t& all();
 
+        ///
+        /// \brief returns a copy of this object (with the same configuration and history)
+        ///
+        /// NB: this is used by the solvers to create cheaply a new line-search object for each minimization
+        ///     (without the factory and the JSON configuration round-trip) from their configured but unused prototype.
+        ///
+        virtual rlsearchk_t clone() const = 0;
+
         ///
         /// \brief compute the step length starting from the given state and the initial estimate of the step length
         ///
         bool get(solver_state_t& state, const scalar_t t0);
 
+        ///
+        /// \brief compute the step length starting from the given state (with a zero step length)
+        ///     and the initial estimate of the step length, by evaluating the trials in place in the given state
+        ///
+        bool get(const solver_state_t& state0, solver_state_t& state, const scalar_t t0);
+
         ///
         /// \brief change parameters
         ///
@@ -79,6 +93,12 @@ namespace nano
         ///
         virtual bool get(const solver_state_t& state0, solver_state_t&) = 0;
 
+        ///
+        /// \brief prepare the line-search along the descent direction of state0 (e.g. precompute data along the line)
+        ///     and returns true if the initial step length should be evaluated before computing the step length
+        ///
+        virtual bool prepare(const solver_state_t&) { return true; }
+
         ///
         /// \brief log the current line-search trial length (if the logger is provided)
         ///
@@ -90,6 +110,25 @@ namespace nano
             }
         }
 
+        ///
+        /// \brief evaluate the given state (with the gradient) at the given step length
+        ///     along the descent direction of state0
+        ///
+        static bool eval(const solver_state_t& state0, solver_state_t& state, const scalar_t t)
+        {
+            return state.update(state0, t);
+        }
+
+        ///
+        /// \brief evaluate an intermediate trial at the given step length along the descent direction of state0:
+        ///     only the function value and the directional derivative if the function supports it
+        ///     (see solver_state_t::trial), as the gradient is needed only at the accepted step.
+        ///
+        static bool trial(const solver_state_t& state0, solver_state_t& state, const scalar_t t)
+        {
+            return state.trial(state0, t);
+        }
+
     private:
 
         // attributes
@@ -6,9 +6,44 @@
 namespace nano
 {
     class solver_t;
+    class tpool_t;
     using solver_factory_t = factory_t<solver_t>;
     using rsolver_t = solver_factory_t::trobject;
 
+    ///
+    /// \brief the optimization states to return when minimizing from multiple starting points.
+    ///
+    enum class solver_multistart
+    {
+        all,                ///< the final states of all runs (in the order of the starting points)
+        best                ///< only the final state with the lowest function value
+    };
+
+    template <>
+    inline enum_map_t<solver_multistart> enum_string<solver_multistart>()
+    {
+        return
+        {
+            { solver_multistart::all,   "all" },
+            { solver_multistart::best,  "best" }
+        };
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const solver_multistart multistart)
+    {
+        return os << to_string(multistart);
+    }
+
+    ///
+    /// \brief policy to minimize from multiple starting points in parallel.
+    ///
+    struct solver_multistart_t
+    {
+        // attributes
+        solver_multistart   m_result{solver_multistart::all};                       ///< which final states to return
+        scalar_t            m_target{-std::numeric_limits<scalar_t>::infinity()};   ///< cancel the other runs once one converges below
+    };
+
     ///
     /// \brief generic optimization algorithm typically using an adaptive line-search method.
     ///
@@ -44,6 +79,29 @@ namespace nano
         ///
         solver_state_t minimize(const function_t&, const vector_t& x0) const;
 
+        ///
+        /// \brief minimize the given function starting in parallel from each of the given initial points.
+        ///
+        /// NB: the runs share nothing mutable (each uses its own line-search objects and evaluation counters),
+        ///     but the logging callbacks (if any) are called concurrently and thus they must be thread-safe.
+        /// NB: the runs not started yet when cancelled return their initial point with the status <stopped>,
+        ///     while the runs in progress stop at the next iteration.
+        ///
+        std::vector<solver_state_t> minimize_multistart(const function_t&, const std::vector<vector_t>& x0s,
+            const solver_multistart_t& policy = solver_multistart_t{}) const;
+
+        std::vector<solver_state_t> minimize_multistart(tpool_t&, const function_t&, const std::vector<vector_t>& x0s,
+            const solver_multistart_t& policy = solver_multistart_t{}) const;
+
+        ///
+        /// \brief minimize the given function starting in parallel from the given number of initial points
+        ///     generated sequentially by the sampler: op(trial) returns the initial point of the given trial.
+        ///
+        using sampler_t = std::function<vector_t(size_t trial)>;
+
+        std::vector<solver_state_t> minimize_multistart(const function_t&, const sampler_t& sampler, size_t trials,
+            const solver_multistart_t& policy = solver_multistart_t{}) const;
+
         ///
         /// \brief configure
         ///
@@ -89,6 +147,11 @@ namespace nano
         const auto& lsearch0_id() const { return m_lsearch0_id; }
         const auto& lsearchk_id() const { return m_lsearchk_id; }
 
+        ///
+        /// \brief check if the solver uses the line-search (e.g. not the case for trust-region methods)
+        ///
+        virtual bool has_lsearch() const { return true; }
+
     protected:
 
         ///
@@ -109,6 +172,8 @@ namespace nano
 
     private:
 
+        solver_state_t minimize(const function_t&, const vector_t& x0, const std::atomic<bool>* stop) const;
+
         // attributes
         scalar_t                    m_c1{0};                    ///<
         scalar_t                    m_c2{0};                    ///<
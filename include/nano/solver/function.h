@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <nano/function.h>
 
 namespace nano
@@ -19,6 +20,18 @@ namespace nano
         {
         }
 
+        ///
+        /// \brief copy constructor (the atomic counters are copied by value)
+        ///
+        solver_function_t(const solver_function_t& other) :
+            function_t(other),
+            m_function(other.m_function),
+            m_fcalls(other.fcalls()),
+            m_gcalls(other.gcalls()),
+            m_stop(other.m_stop)
+        {
+        }
+
         ///
         /// \brief compute function value (and gradient if provided)
         ///
@@ -29,6 +42,46 @@ namespace nano
             return m_function.vgrad(x, gx);
         }
 
+        ///
+        /// \brief compute the function value and the directional derivative (counted as a function evaluation)
+        ///
+        bool vdir(const vector_t& x, const vector_t& d, scalar_t& fx, scalar_t& dg) const override
+        {
+            const auto ok = m_function.vdir(x, d, fx, dg);
+            m_fcalls += ok ? 1 : 0;
+            return ok;
+        }
+
+        ///
+        /// \brief compute the restriction of the function to a line (counted as a gradient evaluation)
+        ///
+        bool line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const override
+        {
+            const auto ok = m_function.line_coeffs(x, d, coeffs);
+            m_gcalls += ok ? 1 : 0;
+            return ok;
+        }
+
+        ///
+        /// \brief evaluate the restriction of the function to a line (not counted as it is cheap)
+        ///
+        scalar_t line_vgrad(const vector_t& coeffs, const scalar_t t, scalar_t& dphi) const override
+        {
+            return m_function.line_vgrad(coeffs, t, dphi);
+        }
+
+        ///
+        /// \brief compute analytically the Hessian-vector product (counted as a gradient evaluation)
+        ///
+        /// NB: otherwise the finite-difference approximation evaluates (and counts) two gradients (see hvprod).
+        ///
+        bool hvprod_analytic(const vector_t& x, const vector_t& v, vector_t& Hv) const override
+        {
+            const auto ok = m_function.hvprod_analytic(x, v, Hv);
+            m_gcalls += ok ? 1 : 0;
+            return ok;
+        }
+
         ///
         /// \brief number of function evaluation calls
         ///
@@ -39,11 +92,22 @@ namespace nano
         ///
         size_t gcalls() const { return m_gcalls; }
 
+        ///
+        /// \brief set the flag signaling externally that the optimization should stop (e.g. multi-start)
+        ///
+        void stop_flag(const std::atomic<bool>* flag) { m_stop = flag; }
+
+        ///
+        /// \brief check if the optimization should stop
+        ///
+        bool stopped() const { return m_stop != nullptr && m_stop->load(std::memory_order_relaxed); }
+
     private:
 
         // attributes
-        const function_t&   m_function;         ///<
-        mutable size_t      m_fcalls{0};        ///< #function value evaluations
-        mutable size_t      m_gcalls{0};        ///< #function gradient evaluations
+        const function_t&           m_function;         ///<
+        mutable std::atomic<size_t> m_fcalls{0};        ///< #function value evaluations (atomic for the parallel line-search trials)
+        mutable std::atomic<size_t> m_gcalls{0};        ///< #function gradient evaluations
+        const std::atomic<bool>*    m_stop{nullptr};    ///< external stopping request (if any)
     };
 }
@@ -53,6 +53,7 @@ namespace nano
             assert(x.size() == function->size());
             x = xx;
             f = function->vgrad(x, &g);
+            m_gradient = true;
             return static_cast<bool>(*this);
         }
 
@@ -65,6 +66,33 @@ namespace nano
             return update(state0.x + t * state0.d);
         }
 
+        ///
+        /// \brief line-search trial along the descent direction of state0:
+        ///     only the function value and the directional derivative are evaluated
+        ///     if the function supports it (see function_t::vdir), otherwise the gradient as well.
+        ///
+        bool trial(const solver_state_t& state0, const scalar_t tt)
+        {
+            assert(function);
+            assert(x.size() == state0.x.size());
+            t = tt;
+            x = state0.x + t * state0.d;
+            m_gradient = !function->vdir(x, state0.d, f, m_dg);
+            if (m_gradient)
+            {
+                f = function->vgrad(x, &g);
+            }
+            return static_cast<bool>(*this);
+        }
+
+        ///
+        /// \brief check if the gradient is evaluated at the current point (see trial)
+        ///
+        bool has_gradient() const
+        {
+            return m_gradient;
+        }
+
         ///
         /// \brief check convergence: the gradient is relatively small
         ///
@@ -86,15 +114,16 @@ namespace nano
         ///
         operator bool() const
         {
-            return std::isfinite(t) && std::isfinite(f) && std::isfinite(convergence_criterion());
+            return  std::isfinite(t) && std::isfinite(f) &&
+                    (m_gradient ? std::isfinite(convergence_criterion()) : std::isfinite(m_dg));
         }
 
         ///
         /// \brief compute the dot product between the gradient and the descent direction
         ///
-        auto dg() const
+        scalar_t dg() const
         {
-            return g.dot(d);
+            return m_gradient ? g.dot(d) : m_dg;
         }
 
         ///
@@ -159,6 +188,9 @@ namespace nano
         size_t              m_fcalls{0};            ///< #function value evaluations so far
         size_t              m_gcalls{0};            ///< #function gradient evaluations so far
         size_t              m_iterations{0};        ///< #optimization iterations so far
+        int64_t             m_nanoseconds{0};       ///< duration of the optimization in nanoseconds
+        scalar_t            m_dg{0};                ///< directional derivative (if the gradient is not evaluated)
+        bool                m_gradient{true};       ///< whether the gradient is evaluated at the current point
     };
 
     template <>
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <functional>
+#include <nano/json.h>
+#include <nano/factory.h>
+#include <nano/solver/state.h>
+
+namespace nano
+{
+    class stoch_solver_t;
+    using stoch_solver_factory_t = factory_t<stoch_solver_t>;
+    using rstoch_solver_t = stoch_solver_factory_t::trobject;
+
+    ///
+    /// \brief finite-sum objective defined as the average of a loss term over (many) samples:
+    ///     f(x) = 1/N * sum(f_i(x), i=1,N),
+    ///     that can be evaluated on contiguous minibatches of the current order of the samples.
+    ///
+    /// NB: the gradient of a sample's term is expressed as:
+    ///     grad(f_i)(x) = expand_i(s_i(x)) + rgrad(x),
+    ///     where s_i(x) is a compact gradient state (e.g. the loss gradient wrt the outputs for linear models)
+    ///     and rgrad(x) is the gradient of the regularization term (common to all samples).
+    ///     By default the gradient state is the gradient itself and there is no separate regularization term.
+    ///
+    class NANO_PUBLIC stoch_function_t : public function_t
+    {
+    public:
+
+        using function_t::function_t;
+        using function_t::vgrad;
+
+        ///
+        /// \brief number of samples
+        ///
+        virtual tensor_size_t samples() const = 0;
+
+        ///
+        /// \brief randomly shuffle the order of the samples (e.g. at the beginning of each epoch)
+        ///
+        virtual void shuffle() = 0;
+
+        ///
+        /// \brief compute the function value (and gradient if provided) of the [begin, end) minibatch of samples
+        ///
+        /// NB: the cost should be proportional to the number of samples in the minibatch.
+        ///
+        virtual scalar_t vgrad(const vector_t& x, tensor_size_t begin, tensor_size_t end,
+            vector_t* gx = nullptr) const = 0;
+
+        ///
+        /// \brief compute the function value (and gradient if provided) of the i-th sample
+        ///
+        virtual scalar_t vgrad_i(const vector_t& x, tensor_size_t i, vector_t* gx = nullptr) const;
+
+        ///
+        /// \brief number of components of the compact per-sample gradient state
+        ///
+        virtual tensor_size_t ssize() const;
+
+        ///
+        /// \brief compute the function value and the compact gradient state of the i-th sample
+        ///
+        virtual scalar_t sgrad_i(const vector_t& x, tensor_size_t i, vector_t& s) const;
+
+        ///
+        /// \brief accumulate the gradient given by the compact gradient state of the i-th sample: g += alpha * expand_i(s)
+        ///
+        virtual void expand_i(tensor_size_t i, const vector_t& s, scalar_t alpha, vector_t& g) const;
+
+        ///
+        /// \brief accumulate the gradient of the regularization term: g += rgrad(x)
+        ///
+        virtual void rgrad(const vector_t& x, vector_t& g) const;
+    };
+
+    ///
+    /// \brief stochastic optimization algorithm that updates the parameters
+    ///     using the gradients of (small) subsets of randomly chosen samples.
+    ///
+    /// NB: the state is evaluated on all samples only at the end of each epoch
+    ///     (for logging and for checking convergence), so an epoch corresponds to an iteration.
+    ///
+    class NANO_PUBLIC stoch_solver_t : public json_configurable_t
+    {
+    public:
+
+        ///
+        /// logging operator: op(state), returns false if the optimization should stop
+        ///
+        using logger_t = std::function<bool(const solver_state_t&)>;
+
+        ///
+        /// \brief returns the available implementations
+        ///
+        static stoch_solver_factory_t& all();
+
+        ///
+        /// \brief minimize the given function starting from the initial point x0 until:
+        ///     - convergence is achieved (relatively small gradient on all samples) or
+        ///     - the maximum number of epochs is reached or
+        ///     - the user canceled the optimization (using the logging function) or
+        ///     - the solver diverged.
+        ///
+        solver_state_t minimize(stoch_function_t&, const vector_t& x0) const;
+
+        ///
+        /// \brief configure
+        ///
+        json_t config() const override;
+        void config(const json_t&) override;
+
+        ///
+        /// \brief set the logging callback
+        ///
+        void logger(const logger_t& logger) { m_logger = logger; }
+
+        ///
+        /// \brief set parameters
+        ///
+        void lrate(const scalar_t lrate) { m_lrate = lrate; }
+        void decay(const scalar_t decay) { m_decay = decay; }
+        void epsilon(const scalar_t epsilon) { m_epsilon = epsilon; }
+        void max_epochs(const int max_epochs) { m_max_epochs = max_epochs; }
+
+        ///
+        /// \brief access functions
+        ///
+        auto lrate() const { return m_lrate; }
+        auto decay() const { return m_decay; }
+        auto epsilon() const { return m_epsilon; }
+        auto max_epochs() const { return m_max_epochs; }
+
+    protected:
+
+        ///
+        /// \brief minimize the given function starting from the (already evaluated and logged) given state
+        ///
+        virtual void minimize(stoch_function_t&, solver_state_t&) const = 0;
+
+        ///
+        /// \brief returns the learning rate to use at the given (0-based) epoch: lrate / (1 + decay * epoch)
+        ///
+        scalar_t epoch_lrate(int epoch) const;
+
+        ///
+        /// \brief evaluate the parameters x on all samples at the end of an epoch that called
+        ///     the given number of times the function, log the state and check if the optimization is done.
+        ///
+        bool done(solver_state_t& state, const vector_t& x, size_t calls) const;
+
+    private:
+
+        bool log(solver_state_t& state) const;
+
+        // attributes
+        scalar_t        m_lrate{1e-2};          ///< learning rate
+        scalar_t        m_decay{0.0};           ///< learning rate decay: lrate / (1 + decay * epoch)
+        scalar_t        m_epsilon{1e-6};        ///< required precision (~magnitude of the gradient)
+        int             m_max_epochs{100};      ///< maximum number of epochs
+        logger_t        m_logger;               ///<
+    };
+}
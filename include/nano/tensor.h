@@ -14,6 +14,9 @@ namespace nano
     using vector_map_t = Eigen::Map<vector_t>;
     using vector_cmap_t = Eigen::Map<const vector_t>;
 
+    using matrix_map_t = Eigen::Map<matrix_t>;
+    using matrix_cmap_t = Eigen::Map<const matrix_t>;
+
     using tensor1d_t = tensor_mem_t<scalar_t, 1>;
     using tensor2d_t = tensor_mem_t<scalar_t, 2>;
     using tensor3d_t = tensor_mem_t<scalar_t, 3>;
@@ -1,20 +1,228 @@
 #pragma once
 
-#include <deque>
 #include <mutex>
-#include <future>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <thread>
 #include <vector>
+#include <limits>
 #include <cassert>
+#include <algorithm>
 #include <condition_variable>
+#include <nano/arch.h>
+#include <nano/random.h>
+#include <nano/string.h>
+#include <nano/tpool/task.h>
+#include <nano/tpool/deque.h>
 
 namespace nano
 {
-    using future_t = std::future<void>;
-    using tpool_task_t = std::packaged_task<void()>;
+    class tpool_t;
+
+    ///
+    /// \brief methods to distribute the enqueued tasks to the worker threads.
+    ///
+    enum class tpool_mode
+    {
+        shared_queue,       ///< single task queue shared by all workers (guarded by a mutex)
+        work_stealing,      ///< per-worker lock-free deques, idle workers steal tasks from the others (default)
+    };
+
+    template <>
+    inline enum_map_t<tpool_mode> enum_string<tpool_mode>()
+    {
+        return
+        {
+            { tpool_mode::shared_queue,     "shared_queue" },
+            { tpool_mode::work_stealing,    "work_stealing" }
+        };
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const tpool_mode mode)
+    {
+        return os << to_string(mode);
+    }
+
+    ///
+    /// \brief priority of the enqueued tasks.
+    ///
+    enum class tpool_priority
+    {
+        normal,             ///< default priority (e.g. bulk processing)
+        high,               ///< executed before the normal priority tasks waiting in the queues (e.g. interactive work)
+    };
+
+    template <>
+    inline enum_map_t<tpool_priority> enum_string<tpool_priority>()
+    {
+        return
+        {
+            { tpool_priority::normal,   "normal" },
+            { tpool_priority::high,     "high" }
+        };
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const tpool_priority priority)
+    {
+        return os << to_string(priority);
+    }
+
+    ///
+    /// \brief methods to distribute the iterations of a parallel loop to tasks (see loopr).
+    ///
+    enum class tpool_schedule
+    {
+        fixed,              ///< one contiguous block per worker (default)
+        dynamic,            ///< the tasks repeatedly grab the next chunk using an atomic counter
+        guided,             ///< like dynamic, but grab blocks proportional to the remaining iterations
+    };
+
+    template <>
+    inline enum_map_t<tpool_schedule> enum_string<tpool_schedule>()
+    {
+        return
+        {
+            { tpool_schedule::fixed,    "fixed" },
+            { tpool_schedule::dynamic,  "dynamic" },
+            { tpool_schedule::guided,   "guided" }
+        };
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const tpool_schedule schedule)
+    {
+        return os << to_string(schedule);
+    }
+
+    ///
+    /// \brief methods to combine the partial results of a parallel reduction (see loop_reduce).
+    ///
+    enum class tpool_reduction
+    {
+        fast,               ///< one accumulator per task, the result depends on the number of workers (default)
+        deterministic,      ///< fixed-sized blocks combined in a fixed binary tree, bitwise reproducible results
+    };
+
+    template <>
+    inline enum_map_t<tpool_reduction> enum_string<tpool_reduction>()
+    {
+        return
+        {
+            { tpool_reduction::fast,            "fast" },
+            { tpool_reduction::deterministic,   "deterministic" }
+        };
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, const tpool_reduction reduction)
+    {
+        return os << to_string(reduction);
+    }
+
+    ///
+    /// \brief thread pool configuration.
+    ///
+    struct NANO_PUBLIC tpool_config_t
+    {
+        ///
+        /// \brief read the configuration from the environment variables (if set):
+        ///     - NANO_TPOOL_MODE: scheduling method (e.g. "work_stealing"),
+        ///     - NANO_TPOOL_WORKERS: number of worker threads,
+        ///     - NANO_TPOOL_CPUS: list of CPUs to pin the worker threads to (e.g. "0-7,16-23"),
+        ///     - NANO_TPOOL_SPIN: number of iterations an idle worker spins before parking.
+        ///
+        static tpool_config_t from_env();
+
+        ///
+        /// \brief parse a list of CPUs given as comma-separated indices or ranges (e.g. "0-3,8,10-11").
+        ///
+        static std::vector<size_t> parse_cpus(const string_t&);
+
+        // attributes
+        tpool_mode          m_mode{tpool_mode::work_stealing};  ///< scheduling method
+        size_t              m_workers{0};       ///< number of worker threads (0 - one per CPU)
+        bool                m_affinity{false};  ///< pin the worker threads to CPUs
+        std::vector<size_t> m_cpus;             ///< CPUs to pin to (empty - all CPUs available to the process)
+        size_t              m_spin{1024};       ///< number of iterations an idle worker spins looking for tasks before parking
+    };
+
+    ///
+    /// \brief returns the CPUs available to the current process.
+    ///
+    NANO_PUBLIC std::vector<size_t> tpool_available_cpus();
+
+    ///
+    /// \brief returns the NUMA node of the given CPU (or 0 if not available).
+    ///
+    NANO_PUBLIC size_t tpool_numa_node(size_t cpu);
+
+    ///
+    /// \brief pin the given thread to the given CPU, returns false if not supported.
+    ///
+    NANO_PUBLIC bool tpool_pin_thread(std::thread&, size_t cpu);
+
+    ///
+    /// \brief hint the CPU that the calling thread is spinning (busy-waiting).
+    ///
+    inline void tpool_pause()
+    {
+    #if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause();
+    #endif
+    }
+
+    ///
+    /// \brief FIFO circular buffer of pointers, grown by doubling its capacity when full.
+    /// NB: the storage is never released, so no heap allocation is performed in the steady state
+    ///     (unlike std::deque which allocates and releases its blocks as the elements are pushed and popped).
+    ///
+    template <typename tvalue>
+    class tpool_ring_t
+    {
+    public:
+
+        bool empty() const { return m_size == 0; }
+
+        void push_back(tvalue value)
+        {
+            if (m_size == m_values.size())
+            {
+                std::vector<tvalue> values(std::max(size_t(64), 2 * m_values.size()));
+                for (size_t i = 0; i < m_size; ++ i)
+                {
+                    values[i] = m_values[(m_begin + i) % m_values.size()];
+                }
+                m_values.swap(values);
+                m_begin = 0;
+            }
+
+            m_values[(m_begin + m_size) % m_values.size()] = value;
+            ++ m_size;
+        }
+
+        tvalue front() const
+        {
+            assert(m_size > 0);
+            return m_values[m_begin];
+        }
+
+        void pop_front()
+        {
+            assert(m_size > 0);
+            m_begin = (m_begin + 1) % m_values.size();
+            -- m_size;
+        }
+
+    private:
+
+        // attributes
+        std::vector<tvalue>     m_values;       ///< storage
+        size_t                  m_begin{0};     ///< index of the oldest element
+        size_t                  m_size{0};      ///< number of elements
+    };
 
     ///
     /// \brief enqueue tasks to be run in a thread pool.
+    /// NB: the high priority tasks are dequeued before the normal priority ones.
     ///
     class tpool_queue_t
     {
@@ -24,48 +232,697 @@ namespace nano
         ///
         tpool_queue_t() = default;
 
-        ///
-        /// \brief enqueue a new task to execute
-        ///
-        template <typename tfunction>
-        auto enqueue(tfunction&& f)
+        ///
+        /// \brief destructor
+        ///
+        ~tpool_queue_t() = default;
+
+        ///
+        /// \brief disable copying
+        ///
+        tpool_queue_t(const tpool_queue_t&) = delete;
+        tpool_queue_t& operator=(const tpool_queue_t&) = delete;
+
+        ///
+        /// \brief enqueue a new task to execute
+        ///
+        void push(tpool_task_t* task, const tpool_priority priority = tpool_priority::normal)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            push_unlocked(task, priority);
+        }
+
+        ///
+        /// \brief enqueue a new task to execute - the mutex must be already acquired
+        ///
+        void push_unlocked(tpool_task_t* task, const tpool_priority priority)
+        {
+            if (priority == tpool_priority::high)
+            {
+                m_high_tasks.push_back(task);
+                m_high_size.fetch_add(1, std::memory_order_seq_cst);
+            }
+            else
+            {
+                m_tasks.push_back(task);
+            }
+            m_size.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ///
+        /// \brief dequeue the oldest task (if any) with the highest priority
+        ///
+        tpool_task_t* pop()
+        {
+            if (m_size.load(std::memory_order_relaxed) == 0)
+            {
+                return nullptr;
+            }
+
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            return pop_unlocked();
+        }
+
+        ///
+        /// \brief dequeue the oldest high priority task (if any)
+        ///
+        tpool_task_t* pop_high()
+        {
+            if (m_high_size.load(std::memory_order_relaxed) == 0)
+            {
+                return nullptr;
+            }
+
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            return pop_unlocked();
+        }
+
+        ///
+        /// \brief dequeue the oldest task (if any) with the highest priority - the mutex must be already acquired
+        ///
+        tpool_task_t* pop_unlocked()
+        {
+            auto* tasks = &m_high_tasks;
+            if (tasks->empty())
+            {
+                tasks = &m_tasks;
+                if (tasks->empty())
+                {
+                    return nullptr;
+                }
+            }
+            else
+            {
+                m_high_size.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            auto* task = tasks->front();
+            tasks->pop_front();
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+
+        ///
+        /// \brief check if there are (approximately) no tasks to execute
+        ///
+        bool empty() const
+        {
+            return m_size.load(std::memory_order_seq_cst) == 0;
+        }
+
+        // attributes
+        tpool_ring_t<tpool_task_t*>     m_tasks;                ///< normal priority tasks to execute
+        tpool_ring_t<tpool_task_t*>     m_high_tasks;           ///< high priority tasks to execute
+        std::atomic<size_t>             m_size{0};              ///< number of tasks to execute
+        std::atomic<size_t>             m_high_size{0};         ///< number of high priority tasks to execute
+        mutable std::mutex              m_mutex;                ///< synchronization
+        mutable std::condition_variable m_condition;            ///< signaling
+        bool                            m_stop{false};          ///< stop requested
+    };
+
+    ///
+    /// \brief worker to process tasks enqueued in a thread pool.
+    ///
+    class tpool_worker_t
+    {
+    public:
+        ///
+        /// \brief constructor
+        ///
+        tpool_worker_t(tpool_t& pool, const size_t index) :
+            m_pool(pool),
+            m_index(index),
+            m_rng(make_rng())
+        {
+        }
+
+        ///
+        /// \brief execute tasks when available
+        ///
+        void operator()();
+
+        ///
+        /// \brief returns the worker associated to the calling thread (if any)
+        ///
+        static tpool_worker_t*& current()
+        {
+            static thread_local tpool_worker_t* worker = nullptr;
+            return worker;
+        }
+
+        // attributes
+        tpool_t&                        m_pool;                 ///< thread pool owning this worker
+        size_t                          m_index{0};             ///< worker index in the thread pool
+        size_t                          m_node{0};              ///< NUMA node (if pinned to a CPU)
+        tpool_deque_t<tpool_task_t*>    m_deque;                ///< local tasks (work-stealing mode only)
+        tpool_queue_t                   m_inbox;                ///< tasks assigned by other threads (work-stealing mode only)
+        std::vector<tpool_worker_t*>    m_local;                ///< other workers on the same NUMA node
+        std::vector<tpool_worker_t*>    m_remote;               ///< workers on other NUMA nodes
+        rng_t                           m_rng;                  ///< to select the worker to steal from
+        std::condition_variable         m_condition;            ///< signaling when parked
+        bool                            m_signaled{false};      ///< wake up requested while parked
+    };
+
+    ///
+    /// \brief thread pool.
+    /// NB: this is heavily copied/inspired by http://progsch.net/wordpress/?p=81
+    ///
+    /// NB: in work-stealing mode each worker owns a lock-free deque:
+    ///     - tasks enqueued by a worker are pushed into its own deque,
+    ///     - tasks enqueued by any other thread are pushed into a shared injection queue,
+    ///     - tasks assigned to a particular worker (only when pinned to CPUs) are pushed into its inbox,
+    ///     - an idle worker steals tasks from randomly selected workers (first from the same NUMA node) and
+    ///     - a worker is parked only when no task is available and it is woken up individually.
+    ///
+    /// NB: a worker waiting for some tasks to finish executes queued tasks meanwhile,
+    ///     so that tasks can enqueue and wait for other tasks (e.g. nested parallel loops) without deadlocking.
+    ///
+    /// NB: an idle worker spins (looking for new tasks) for a configurable number of iterations before parking
+    ///     and it keeps spinning while in hot-loop mode (see tpool_hot_loop_t),
+    ///     to avoid the latency of waking up parked workers for short back-to-back parallel loops.
+    ///
+    /// NB: the workers pinned to CPUs are ordered by NUMA node,
+    ///     so that consecutive worker indices (and thus consecutive loop blocks) share the same memory node.
+    ///
+    class tpool_t
+    {
+    public:
+
+        ///
+        /// \brief single instance
+        /// NB: its configuration is set using tpool_t::configure or otherwise from the environment variables.
+        ///
+        static tpool_t& instance()
+        {
+            static tpool_t the_pool(instance_config());
+            return the_pool;
+        }
+
+        ///
+        /// \brief set the configuration of the single instance,
+        ///     throws an exception if the single instance is already used.
+        ///
+        NANO_PUBLIC static void configure(const tpool_config_t&);
+
+        ///
+        /// \brief named instance (created at first use) independent of the single instance,
+        ///     e.g. to run latency-sensitive work separately from long batch jobs.
+        /// NB: its configuration is set using tpool_t::configure(name, ...) or otherwise from the environment variables.
+        ///
+        NANO_PUBLIC static tpool_t& instance(const string_t& name);
+
+        ///
+        /// \brief set the configuration of the named instance,
+        ///     throws an exception if the named instance is already used.
+        ///
+        NANO_PUBLIC static void configure(const string_t& name, const tpool_config_t&);
+
+        ///
+        /// \brief constructor
+        ///
+        explicit tpool_t(const tpool_mode mode = tpool_mode::work_stealing, const size_t n_workers = size()) :
+            tpool_t(make_config(mode, n_workers))
+        {
+        }
+
+        ///
+        /// \brief constructor
+        ///
+        explicit tpool_t(const tpool_config_t& config) :
+            m_mode(config.m_mode),
+            m_spin(config.m_spin),
+            m_affinity(config.m_affinity)
+        {
+            auto cpus = config.m_cpus.empty() ? tpool_available_cpus() : config.m_cpus;
+            std::stable_sort(cpus.begin(), cpus.end(), [] (const size_t cpu1, const size_t cpu2)
+            {
+                return tpool_numa_node(cpu1) < tpool_numa_node(cpu2);
+            });
+
+            const auto n_workers = config.m_workers > 0 ? config.m_workers :
+                (config.m_affinity ? cpus.size() : size());
+            assert(n_workers > 0);
+
+            m_workers.reserve(n_workers);
+            for (size_t i = 0; i < n_workers; ++ i)
+            {
+                m_workers.push_back(std::make_unique<tpool_worker_t>(*this, i));
+                if (config.m_affinity && !cpus.empty())
+                {
+                    m_workers.back()->m_node = tpool_numa_node(cpus[i % cpus.size()]);
+                }
+            }
+
+            for (auto& worker : m_workers)
+            {
+                for (auto& other : m_workers)
+                {
+                    if (other != worker)
+                    {
+                        (other->m_node == worker->m_node ? worker->m_local : worker->m_remote).push_back(other.get());
+                    }
+                }
+            }
+
+            // NB: no allocation when parking the workers
+            m_parked.reserve(n_workers);
+
+            m_threads.reserve(n_workers);
+            for (size_t i = 0; i < n_workers; ++ i)
+            {
+                m_threads.emplace_back(std::ref(*m_workers[i]));
+                if (config.m_affinity && !cpus.empty())
+                {
+                    tpool_pin_thread(m_threads.back(), cpus[i % cpus.size()]);
+                }
+            }
+        }
+
+        ///
+        /// \brief disable copying
+        ///
+        tpool_t(const tpool_t&) = delete;
+        tpool_t& operator=(const tpool_t&) = delete;
+
+        ///
+        /// \brief disable moving
+        ///
+        tpool_t(tpool_t&&) = delete;
+        tpool_t& operator=(tpool_t&&) = delete;
+
+        ///
+        /// \brief destructor
+        ///
+        ~tpool_t()
+        {
+            stop();
+
+            // NB: release the tasks not processed (if any)
+            tpool_task_t* task = nullptr;
+            while ((task = m_queue.pop()) != nullptr)
+            {
+                release(task);
+            }
+            for (auto& worker : m_workers)
+            {
+                while (worker->m_deque.pop(task))
+                {
+                    release(task);
+                }
+                while ((task = worker->m_inbox.pop()) != nullptr)
+                {
+                    release(task);
+                }
+            }
+        }
+
+        ///
+        /// \brief enqueue a new task to execute (fire-and-forget)
+        ///
+        template <typename tfunction>
+        void enqueue(tfunction&& f, const tpool_priority priority = tpool_priority::normal)
+        {
+            submit(std::forward<tfunction>(f), nullptr, npos, priority);
+        }
+
+        ///
+        /// \brief enqueue a new task to execute and signal the given latch when done
+        /// NB: the latch must be incremented before calling this function (see tpool_section_t).
+        ///
+        template <typename tfunction>
+        void enqueue(tpool_latch_t& latch, tfunction&& f, const tpool_priority priority = tpool_priority::normal)
+        {
+            submit(std::forward<tfunction>(f), &latch, npos, priority);
+        }
+
+        ///
+        /// \brief enqueue a new task to execute preferably by the given worker and signal the given latch when done
+        /// NB: the task may still be executed by some other (idle) worker.
+        ///
+        template <typename tfunction>
+        void enqueue(tpool_latch_t& latch, const size_t worker, tfunction&& f,
+            const tpool_priority priority = tpool_priority::normal)
+        {
+            submit(std::forward<tfunction>(f), &latch, worker, priority);
+        }
+
+        ///
+        /// \brief block until all tasks associated to the given latch are done.
+        ///
+        /// NB: if called from a worker thread of this pool, then the worker keeps executing the queued tasks
+        ///     while waiting (help-while-waiting), so that parallel loops can be safely nested.
+        ///
+        void wait(const tpool_latch_t& latch)
+        {
+            auto* worker = current_worker();
+            if (worker == nullptr)
+            {
+                latch.wait();
+                return;
+            }
+
+            while (!latch.done())
+            {
+                auto* task = help(*worker);
+                if (task != nullptr)
+                {
+                    execute(task);
+                }
+                else
+                {
+                    // NB: the remaining tasks are being executed by other workers,
+                    //  but wake up regularly to help with the tasks they may enqueue.
+                    latch.wait_for(std::chrono::microseconds(100));
+                }
+            }
+
+            // NB: synchronize with the last task through the latch's mutex before returning,
+            //  as the latch may be destroyed right after (e.g. by the destructor of tpool_section_t)
+            //  while the last task is still notifying.
+            latch.wait();
+        }
+
+        ///
+        /// \brief enter the hot-loop mode: the idle workers keep spinning instead of parking until
+        ///     the matching call to stop_hot_loop (see tpool_hot_loop_t).
+        ///
+        void start_hot_loop()
+        {
+            {
+                const std::lock_guard<std::mutex> lock(m_park_mutex);
+                m_hot.fetch_add(1, std::memory_order_seq_cst);
+                for (auto* worker : m_parked)
+                {
+                    worker->m_signaled = true;
+                    worker->m_condition.notify_one();
+                }
+                m_parked.clear();
+            }
+            {
+                const std::lock_guard<std::mutex> lock(m_queue.m_mutex);
+                m_queue.m_condition.notify_all();
+            }
+        }
+
+        ///
+        /// \brief leave the hot-loop mode
+        ///
+        void stop_hot_loop()
+        {
+            const std::lock_guard<std::mutex> lock(m_park_mutex);
+            m_hot.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        ///
+        /// \brief number of available worker threads
+        ///
+        static size_t size()
+        {
+            return std::max(size_t(1), static_cast<size_t>(std::thread::hardware_concurrency()));
+        }
+
+        ///
+        /// \brief number of worker threads of this thread pool
+        ///
+        size_t workers() const
+        {
+            return m_workers.size();
+        }
+
+        ///
+        /// \brief scheduling method
+        ///
+        tpool_mode mode() const
+        {
+            return m_mode;
+        }
+
+    private:
+
+        friend class tpool_worker_t;
+
+        NANO_PUBLIC static tpool_config_t instance_config();
+
+        static tpool_config_t make_config(const tpool_mode mode, const size_t n_workers)
+        {
+            tpool_config_t config;
+            config.m_mode = mode;
+            config.m_workers = n_workers;
+            return config;
+        }
+
+        template <typename tfunction>
+        void submit(tfunction&& f, tpool_latch_t* latch, const size_t worker, const tpool_priority priority)
+        {
+            auto* task = m_arena.acquire();
+            task->assign(std::forward<tfunction>(f), latch);
+            push(task, worker, priority);
+        }
+
+        void execute(tpool_task_t* task)
+        {
+            (*task)();
+            m_arena.release(task);
+        }
+
+        void release(tpool_task_t* task)
+        {
+            task->reset();
+            m_arena.release(task);
+        }
+
+        tpool_worker_t* current_worker() const
+        {
+            auto* worker = tpool_worker_t::current();
+            return (worker != nullptr && &worker->m_pool == this) ? worker : nullptr;
+        }
+
+        void push(tpool_task_t* task, const size_t hint, const tpool_priority priority)
+        {
+            switch (m_mode)
+            {
+            case tpool_mode::shared_queue:
+                {
+                    const std::lock_guard<std::mutex> lock(m_queue.m_mutex);
+                    m_queue.push_unlocked(task, priority);
+                    m_queue.m_condition.notify_all();
+                }
+                break;
+
+            case tpool_mode::work_stealing:
+            default:
+                {
+                    // NB: the high priority tasks are visible to all workers before their own tasks
+                    // NB: the worker hint is used only to keep the blocks of the parallel loops issued from outside
+                    //  on the same (NUMA node-local) workers, when the workers are pinned to CPUs.
+                    //  otherwise (e.g. nested loops) the lock-free deque of the calling worker is preferred,
+                    //  at the cost of not reusing the same worker for the same block across calls.
+                    auto* worker = current_worker();
+                    if (hint != npos && m_affinity && worker == nullptr)
+                    {
+                        auto& target = *m_workers[hint % m_workers.size()];
+                        target.m_inbox.push(task, priority);
+                        wake(&target);
+                    }
+                    else if (worker != nullptr && priority == tpool_priority::normal)
+                    {
+                        worker->m_deque.push(task);
+                        wake(nullptr);
+                    }
+                    else
+                    {
+                        m_queue.push(task, priority);
+                        wake(nullptr);
+                    }
+                }
+                break;
+            }
+        }
+
+        tpool_task_t* pop(tpool_worker_t& worker)
+        {
+            tpool_task_t* task = nullptr;
+
+            // high priority tasks first...
+            if ((task = m_queue.pop_high()) != nullptr || (task = worker.m_inbox.pop_high()) != nullptr)
+            {
+                return task;
+            }
+
+            // ... then own tasks (the most recent to benefit from the cache)...
+            if (worker.m_deque.pop(task))
+            {
+                return task;
+            }
+
+            // ... then the tasks assigned to this worker
+            if ((task = worker.m_inbox.pop()) != nullptr)
+            {
+                return task;
+            }
+
+            // ... then the tasks enqueued from outside the thread pool
+            if ((task = m_queue.pop()) != nullptr)
+            {
+                return task;
+            }
+
+            // ... and finally steal the oldest task from some randomly selected worker (from the same NUMA node first)
+            if ((task = steal(worker, worker.m_local)) != nullptr ||
+                (task = steal(worker, worker.m_remote)) != nullptr)
+            {
+                return task;
+            }
+
+            return nullptr;
+        }
+
+        static tpool_task_t* steal(tpool_worker_t& worker, const std::vector<tpool_worker_t*>& victims)
         {
-            auto task = tpool_task_t(f);
-            auto future = task.get_future();
+            tpool_task_t* task = nullptr;
 
-            const std::lock_guard<std::mutex> lock(m_mutex);
-            m_tasks.emplace_back(std::move(task));
-            m_condition.notify_all();
+            const auto n_victims = victims.size();
+            const auto offset = n_victims > 0 ? static_cast<size_t>(worker.m_rng()) % n_victims : size_t(0);
+            for (size_t i = 0; i < n_victims; ++ i)
+            {
+                auto& victim = *victims[(offset + i) % n_victims];
+                if (victim.m_deque.steal(task) || (task = victim.m_inbox.pop()) != nullptr)
+                {
+                    return task;
+                }
+            }
 
-            return future;
+            return nullptr;
         }
 
-        // attributes
-        std::deque<tpool_task_t>        m_tasks;                ///< tasks to execute
-        mutable std::mutex              m_mutex;                ///< synchronization
-        mutable std::condition_variable m_condition;            ///< signaling
-        bool                            m_stop{false};          ///< stop requested
-    };
+        tpool_task_t* help(tpool_worker_t& worker)
+        {
+            switch (m_mode)
+            {
+            case tpool_mode::shared_queue:
+                return m_queue.pop();
 
-    ///
-    /// \brief worker to process tasks enqueued in a thread pool.
-    ///
-    class tpool_worker_t
-    {
-    public:
-        ///
-        /// \brief constructor
-        ///
-        explicit tpool_worker_t(tpool_queue_t& queue) : m_queue(queue) {}
+            case tpool_mode::work_stealing:
+            default:
+                return pop(worker);
+            }
+        }
 
-        ///
-        /// \brief execute tasks when available
-        ///
-        void operator()() const
+        bool has_tasks() const
+        {
+            if (!m_queue.empty())
+            {
+                return true;
+            }
+
+            for (const auto& worker : m_workers)
+            {
+                if (!worker->m_deque.empty() || !worker->m_inbox.empty())
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool park(tpool_worker_t& worker)
+        {
+            std::unique_lock<std::mutex> lock(m_park_mutex);
+
+            // NB: announce the intention to park before checking for tasks,
+            //  so that either this worker finds the new task or the producer finds this worker.
+            m_n_parked.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (!m_park_stop && m_hot.load(std::memory_order_relaxed) == 0 && !has_tasks())
+            {
+                worker.m_signaled = false;
+                m_parked.push_back(&worker);
+                worker.m_condition.wait(lock, [&] { return worker.m_signaled || m_park_stop; });
+            }
+
+            m_n_parked.fetch_sub(1, std::memory_order_relaxed);
+            return !m_park_stop;
+        }
+
+        void wake(tpool_worker_t* preferred)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_n_parked.load(std::memory_order_seq_cst) == 0)
+            {
+                return;
+            }
+
+            const std::lock_guard<std::mutex> lock(m_park_mutex);
+            if (!m_parked.empty())
+            {
+                // NB: wake up the preferred worker if parked, otherwise any parked worker
+                auto it = std::find(m_parked.begin(), m_parked.end(), preferred);
+                it = (it == m_parked.end()) ? (m_parked.end() - 1) : it;
+
+                auto* worker = *it;
+                m_parked.erase(it);
+
+                worker->m_signaled = true;
+                worker->m_condition.notify_one();
+            }
+        }
+
+        void stop()
+        {
+            // stop & join
+            m_park_stop = true;
+            {
+                const std::lock_guard<std::mutex> lock(m_queue.m_mutex);
+                m_queue.m_stop = true;
+                m_queue.m_condition.notify_all();
+            }
+            {
+                const std::lock_guard<std::mutex> lock(m_park_mutex);
+                for (auto* worker : m_parked)
+                {
+                    worker->m_condition.notify_one();
+                }
+                m_parked.clear();
+            }
+
+            for (auto& thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        bool spin(size_t& spins) const
+        {
+            if (m_park_stop.load(std::memory_order_relaxed) ||
+                (m_hot.load(std::memory_order_relaxed) == 0 && spins >= m_spin))
+            {
+                return false;
+            }
+
+            // NB: yield regularly in case the machine is oversubscribed
+            if ((++ spins) % 64 == 0)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                tpool_pause();
+            }
+            return true;
+        }
+
+        void run_shared_queue()
         {
             while (true)
             {
-                tpool_task_t task;
+                // spin before blocking
+                for (size_t spins = 0; m_queue.empty() && spin(spins); )
+                {
+                }
+
+                tpool_task_t* task = nullptr;
 
                 // wait for a new task to be available in the queue
                 {
@@ -73,203 +930,405 @@ namespace nano
 
                     m_queue.m_condition.wait(lock, [&]
                     {
-                        return m_queue.m_stop || !m_queue.m_tasks.empty();
+                        return m_queue.m_stop || !m_queue.empty() || m_hot.load(std::memory_order_relaxed) > 0;
                     });
 
                     if (m_queue.m_stop)
                     {
-                        m_queue.m_tasks.clear();
                         m_queue.m_condition.notify_all();
                         break;
                     }
 
-                    task = std::move(m_queue.m_tasks.front());
-                    m_queue.m_tasks.pop_front();
+                    task = m_queue.pop_unlocked();
+                }
+
+                // execute the task (if not woken up to spin in hot-loop mode)
+                if (task != nullptr)
+                {
+                    execute(task);
                 }
+            }
+        }
 
-                // execute the task
-                task();
+        void run_work_stealing(tpool_worker_t& worker)
+        {
+            for (size_t spins = 0; ; )
+            {
+                auto* task = pop(worker);
+                if (task != nullptr)
+                {
+                    execute(task);
+                    spins = 0;
+                }
+                else if (spin(spins))
+                {
+                    continue;
+                }
+                else if (!park(worker))
+                {
+                    break;
+                }
+                else
+                {
+                    spins = 0;
+                }
             }
         }
 
     private:
 
+        using workers_t = std::vector<std::unique_ptr<tpool_worker_t>>;
+
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
         // attributes
-        tpool_queue_t&          m_queue;        ///< task queue to process
+        tpool_mode                      m_mode{tpool_mode::work_stealing};  ///<
+        size_t                          m_spin{0};      ///< number of iterations to spin before parking
+        bool                            m_affinity{false};///< workers pinned to CPUs (use the worker hints)
+        tpool_arena_t                   m_arena;        ///< preallocated tasks
+        std::vector<std::thread>        m_threads;      ///<
+        workers_t                       m_workers;      ///<
+        tpool_queue_t                   m_queue;        ///< tasks to execute + synchronization (shared or injection queue)
+        std::mutex                      m_park_mutex;   ///< synchronization of the parked workers
+        std::vector<tpool_worker_t*>    m_parked;       ///< parked workers waiting for tasks
+        std::atomic<size_t>             m_n_parked{0};  ///< number of workers about to park or parked
+        std::atomic<bool>               m_park_stop{false};///< stop requested
+        std::atomic<size_t>             m_hot{0};       ///< hot-loop mode requests (see tpool_hot_loop_t)
     };
 
+    inline void tpool_worker_t::operator()()
+    {
+        current() = this;
+
+        switch (m_pool.mode())
+        {
+        case tpool_mode::shared_queue:
+            m_pool.run_shared_queue();
+            break;
+
+        case tpool_mode::work_stealing:
+        default:
+            m_pool.run_work_stealing(*this);
+            break;
+        }
+
+        current() = nullptr;
+    }
+
     ///
-    /// \brief RAII object to wait for a given set of futures (aka barrier).
+    /// \brief RAII object to keep the idle workers of a thread pool spinning while alive (aka hot-loop mode),
+    ///     to minimize the latency of many short back-to-back parallel loops (e.g. in the inner loop of a solver).
+    /// NB: the idle workers burn CPU cycles in this mode!
     ///
-    template <typename tfuture>
-    class tpool_section_t : public std::vector<tfuture>
+    class tpool_hot_loop_t
     {
     public:
+        ///
+        /// \brief constructor
+        ///
+        explicit tpool_hot_loop_t(tpool_t& pool = tpool_t::instance()) :
+            m_pool(pool)
+        {
+            m_pool.start_hot_loop();
+        }
+
+        ///
+        /// \brief disable copying
+        ///
+        tpool_hot_loop_t(const tpool_hot_loop_t&) = delete;
+        tpool_hot_loop_t& operator=(const tpool_hot_loop_t&) = delete;
 
-        using std::vector<tfuture>::vector;
+        ///
+        /// \brief disable moving
+        ///
+        tpool_hot_loop_t(tpool_hot_loop_t&&) = delete;
+        tpool_hot_loop_t& operator=(tpool_hot_loop_t&&) = delete;
 
         ///
         /// \brief destructor
         ///
-        ~tpool_section_t()
+        ~tpool_hot_loop_t()
         {
-            // block until all futures are done
-            for (auto it = this->begin(); it != this->end(); ++ it)
-            {
-                it->wait();
-            }
+            m_pool.stop_hot_loop();
         }
+
+    private:
+
+        // attributes
+        tpool_t&        m_pool;         ///<
     };
 
     ///
-    /// \brief thread pool.
-    /// NB: this is heavily copied/inspired by http://progsch.net/wordpress/?p=81
+    /// \brief RAII object to wait for a given set of tasks (aka barrier).
+    /// NB: the tasks signal a single latch when done, so no per-task synchronization state is allocated.
     ///
-    class tpool_t
+    class tpool_section_t
     {
     public:
-
         ///
-        /// \brief single instance
+        /// \brief constructor
         ///
-        static tpool_t& instance()
+        explicit tpool_section_t(tpool_t& pool = tpool_t::instance(),
+            const tpool_priority priority = tpool_priority::normal) :
+            m_pool(pool),
+            m_priority(priority)
         {
-            static tpool_t the_pool;
-            return the_pool;
         }
 
         ///
         /// \brief disable copying
         ///
-        tpool_t(const tpool_t&) = delete;
-        tpool_t& operator=(const tpool_t&) = delete;
+        tpool_section_t(const tpool_section_t&) = delete;
+        tpool_section_t& operator=(const tpool_section_t&) = delete;
 
         ///
         /// \brief disable moving
         ///
-        tpool_t(tpool_t&&) = delete;
-        tpool_t& operator=(tpool_t&&) = delete;
+        tpool_section_t(tpool_section_t&&) = delete;
+        tpool_section_t& operator=(tpool_section_t&&) = delete;
 
         ///
         /// \brief destructor
         ///
-        ~tpool_t()
+        ~tpool_section_t()
         {
-            stop();
+            // block until all tasks are done
+            m_pool.wait(m_latch);
         }
 
         ///
         /// \brief enqueue a new task to execute
         ///
         template <typename tfunction>
-        auto enqueue(tfunction f)
+        void enqueue(tfunction&& f)
         {
-            return m_queue.enqueue(std::move(f));
+            m_latch.add(1);
+            m_pool.enqueue(m_latch, std::forward<tfunction>(f), m_priority);
         }
 
         ///
-        /// \brief number of available worker threads
+        /// \brief enqueue a new task to execute preferably by the given worker
         ///
-        static size_t size()
-        {
-            return std::max(size_t(1), static_cast<size_t>(std::thread::hardware_concurrency()));
-        }
-
-    private:
-
-        tpool_t()
+        template <typename tfunction>
+        void enqueue(const size_t worker, tfunction&& f)
         {
-            const auto n_workers = size();
-
-            m_workers.reserve(n_workers);
-            for (size_t i = 0; i < n_workers; ++ i)
-            {
-                m_workers.emplace_back(m_queue);
-            }
-
-            for (size_t i = 0; i < n_workers; ++ i)
-            {
-                m_threads.emplace_back(std::ref(m_workers[i]));
-            }
+            m_latch.add(1);
+            m_pool.enqueue(m_latch, worker, std::forward<tfunction>(f), m_priority);
         }
 
-        void stop()
+        ///
+        /// \brief block until all tasks are done and rethrow the first exception thrown by the tasks (if any)
+        ///
+        void wait()
         {
-            // stop & join
-            {
-                const std::lock_guard<std::mutex> lock(m_queue.m_mutex);
-                m_queue.m_stop = true;
-                m_queue.m_condition.notify_all();
-            }
-
-            for (auto& thread : m_threads)
-            {
-                thread.join();
-            }
+            m_pool.wait(m_latch);
+            m_latch.rethrow();
         }
 
     private:
 
         // attributes
-        std::vector<std::thread>        m_threads;      ///<
-        std::vector<tpool_worker_t>     m_workers;      ///<
-        tpool_queue_t                   m_queue;        ///< tasks to execute + synchronization
+        tpool_t&        m_pool;         ///<
+        tpool_priority  m_priority;     ///< priority of the enqueued tasks
+        tpool_latch_t   m_latch;        ///< number of tasks still running
     };
 
     ///
     /// \brief split a loop computation of the given size in fixed-sized chunks using a thread pool.
     /// NB: the operator receives the range [begin, end) to process and the assigned thread index: op(begin, end, tnum)
+    /// NB: the ranges have at most the given chunk size and they are distributed to the tasks using the given policy.
+    /// NB: if the workers are pinned to CPUs and the loop is called from outside the thread pool,
+    ///     the task tnum is assigned preferably to the worker tnum, so that repeated calls process
+    ///     the same blocks on the same (NUMA node-local) workers with the fixed scheduling policy.
+    /// NB: the loops can be nested (e.g. the operator can call loopr/loopi).
     ///
     template <typename tsize, typename toperator>
-    void loopr(const tsize size, const tsize chunk, const toperator& op)
+    void loopr(tpool_t& pool, const tsize size, const tsize chunk, const toperator& op,
+        const tpool_schedule schedule = tpool_schedule::fixed, const tpool_priority priority = tpool_priority::normal)
     {
         assert(size >= tsize(0));
         assert(chunk >= tsize(1));
 
-        auto& pool = tpool_t::instance();
-        const auto workers = static_cast<tsize>(pool.size());
-        const auto tchunk = std::max((size + workers - 1) / workers, chunk);
+        const auto workers = static_cast<tsize>(pool.workers());
+        const auto process = [&op, chunk=chunk] (const tsize tbegin, const tsize tend, const tsize tnum)
+        {
+            for (auto begin = tbegin; begin < tend; begin += chunk)
+            {
+                op(begin, std::min(begin + chunk, tend), tnum);
+            }
+        };
 
-        tpool_section_t<future_t> section;
-        for (tsize tnum = 0, tbegin = 0; tnum < workers && tbegin < size; ++ tnum, tbegin += tchunk)
+        tpool_section_t section(pool, priority);
+        switch (schedule)
         {
-            section.push_back(pool.enqueue([&op, size=size, chunk=chunk, tchunk=tchunk, tnum=tnum, tbegin=tbegin] ()
+        case tpool_schedule::dynamic:
+        case tpool_schedule::guided:
+            {
+                const auto tasks = std::min(workers, (size + chunk - 1) / chunk);
+                const auto guided = schedule == tpool_schedule::guided;
+
+                std::atomic<tsize> next{0};
+                for (tsize tnum = 0; tnum < tasks; ++ tnum)
+                {
+                    section.enqueue(static_cast<size_t>(tnum), [&, tnum=tnum] ()
+                    {
+                        auto tbegin = next.load(std::memory_order_relaxed);
+                        while (tbegin < size)
+                        {
+                            const auto tchunk = guided ? std::max(chunk, (size - tbegin) / (2 * workers)) : chunk;
+                            if (next.compare_exchange_weak(tbegin, tbegin + tchunk, std::memory_order_relaxed))
+                            {
+                                process(tbegin, std::min(tbegin + tchunk, size), tnum);
+                                tbegin = next.load(std::memory_order_relaxed);
+                            }
+                        }
+                    });
+                }
+
+                section.wait();
+            }
+            break;
+
+        case tpool_schedule::fixed:
+        default:
             {
-                for (auto begin = tbegin, tend = std::min(tbegin + tchunk, size); begin < tend; begin += chunk)
+                const auto tchunk = std::max((size + workers - 1) / workers, chunk);
+                for (tsize tnum = 0, tbegin = 0; tnum < workers && tbegin < size; ++ tnum, tbegin += tchunk)
                 {
-                    op(begin, std::min(begin + chunk, tend), tnum);
+                    section.enqueue(static_cast<size_t>(tnum), [&process, size=size, tchunk=tchunk, tnum=tnum, tbegin=tbegin] ()
+                    {
+                        process(tbegin, std::min(tbegin + tchunk, size), tnum);
+                    });
                 }
-            }));
+
+                section.wait();
+            }
+            break;
         }
+    }
 
-        // NB: the section is destroyed here waiting for all tasks to finish!
+    template <typename tsize, typename toperator>
+    void loopr(const tsize size, const tsize chunk, const toperator& op,
+        const tpool_schedule schedule = tpool_schedule::fixed, const tpool_priority priority = tpool_priority::normal)
+    {
+        loopr(tpool_t::instance(), size, chunk, op, schedule, priority);
     }
 
     ///
     /// \brief split a loop computation of the given size using a thread pool.
     /// NB: the operator receives the index to process and the assigned thread index: op(index, tnum)
+    /// NB: the loops can be nested (e.g. the operator can call loopr/loopi).
     ///
     template <typename tsize, typename toperator>
-    void loopi(const tsize size, const toperator& op)
+    void loopi(tpool_t& pool, const tsize size, const toperator& op,
+        const tpool_priority priority = tpool_priority::normal)
     {
         assert(size >= tsize(0));
 
-        auto& pool = tpool_t::instance();
-        const auto workers = static_cast<tsize>(pool.size());
+        const auto workers = static_cast<tsize>(pool.workers());
         const auto tchunk = (size + workers - 1) / workers;
 
-        tpool_section_t<future_t> section;
+        tpool_section_t section(pool, priority);
         for (tsize tnum = 0, tbegin = 0; tnum < workers && tbegin < size; ++ tnum, tbegin += tchunk)
         {
-            section.push_back(pool.enqueue([&op, size=size, tchunk=tchunk, tnum=tnum, tbegin=tbegin] ()
+            section.enqueue(static_cast<size_t>(tnum), [&op, size=size, tchunk=tchunk, tnum=tnum, tbegin=tbegin] ()
             {
                 for (auto begin = tbegin, tend = std::min(tbegin + tchunk, size); begin < tend; ++ begin)
                 {
                     op(begin, tnum);
                 }
-            }));
+            });
+        }
+
+        section.wait();
+    }
+
+    template <typename tsize, typename toperator>
+    void loopi(const tsize size, const toperator& op, const tpool_priority priority = tpool_priority::normal)
+    {
+        loopi(tpool_t::instance(), size, op, priority);
+    }
+
+    ///
+    /// \brief reduce a loop computation of the given size using a thread pool.
+    ///
+    /// NB: the mapping operator returns the partial result of the range [begin, end): map(begin, end),
+    ///     which is accumulated with the other partial results using the combining operator: combine(value1, value2).
+    /// NB: the combining operator must be associative and the initial value is combined only once.
+    ///
+    /// NB: the fast reduction uses one cache-line padded accumulator per task to avoid false sharing,
+    ///     but the order of operations (and thus the floating-point rounding) depends on the number of workers.
+    ///
+    /// NB: the deterministic reduction maps fixed blocks of the given chunk size and
+    ///     combines them in a fixed pairwise tree, so that the result is bitwise reproducible
+    ///     independently of the number of workers (at the cost of storing one partial result per block).
+    ///
+    template <typename tsize, typename tvalue, typename tmap, typename tcombine>
+    tvalue loop_reduce(tpool_t& pool, const tsize size, const tsize chunk, tvalue init,
+        const tmap& map, const tcombine& combine, const tpool_reduction reduction = tpool_reduction::fast)
+    {
+        assert(size >= tsize(0));
+        assert(chunk >= tsize(1));
+
+        switch (reduction)
+        {
+        case tpool_reduction::deterministic:
+            {
+                const auto blocks = (size + chunk - 1) / chunk;
+
+                std::vector<tvalue> values(static_cast<size_t>(blocks), init);
+                loopi(pool, blocks, [&] (const tsize block, const tsize)
+                {
+                    const auto begin = block * chunk;
+                    values[static_cast<size_t>(block)] = map(begin, std::min(begin + chunk, size));
+                });
+
+                for (size_t stride = 1; stride < values.size(); stride *= 2)
+                {
+                    for (size_t i = 0; i + stride < values.size(); i += 2 * stride)
+                    {
+                        values[i] = combine(values[i], values[i + stride]);
+                    }
+                }
+
+                return values.empty() ? init : combine(init, values[0]);
+            }
+
+        case tpool_reduction::fast:
+        default:
+            {
+                struct accumulator_t
+                {
+                    tvalue  m_value;                ///< partial result
+                    bool    m_valid{false};         ///< at least one range processed
+                    char    m_padding[64]{};        ///< avoid false sharing with the neighbouring accumulators
+                };
+
+                std::vector<accumulator_t> accumulators(pool.workers(), accumulator_t{init});
+                loopr(pool, size, chunk, [&] (const tsize begin, const tsize end, const tsize tnum)
+                {
+                    auto& accumulator = accumulators[static_cast<size_t>(tnum)];
+                    accumulator.m_value = accumulator.m_valid ?
+                        combine(accumulator.m_value, map(begin, end)) : map(begin, end);
+                    accumulator.m_valid = true;
+                });
+
+                for (const auto& accumulator : accumulators)
+                {
+                    if (accumulator.m_valid)
+                    {
+                        init = combine(init, accumulator.m_value);
+                    }
+                }
+                return init;
+            }
         }
+    }
 
-        // NB: the section is destroyed here waiting for all tasks to finish!
+    template <typename tsize, typename tvalue, typename tmap, typename tcombine>
+    tvalue loop_reduce(const tsize size, const tsize chunk, tvalue init,
+        const tmap& map, const tcombine& combine, const tpool_reduction reduction = tpool_reduction::fast)
+    {
+        return loop_reduce(tpool_t::instance(), size, chunk, std::move(init), map, combine, reduction);
     }
 }
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+namespace nano
+{
+    ///
+    /// \brief lock-free work-stealing deque:
+    ///     - the owner thread pushes and pops elements at the bottom end (LIFO) and
+    ///     - the other threads steal elements from the top end (FIFO).
+    ///
+    ///     see "Dynamic Circular Work-Stealing Deque", by D. Chase and Y. Lev, 2005
+    ///     see "Correct and Efficient Work-Stealing for Weak Memory Models", by N. M. Le et al., 2013
+    ///
+    /// NB: the stored values must be trivially copyable (e.g. pointers to tasks).
+    /// NB: the buffers are grown by the owner and the old buffers are released only at destruction,
+    ///     as concurrent thieves may still read from them.
+    ///
+    template <typename tvalue>
+    class tpool_deque_t
+    {
+    public:
+
+        static_assert(std::is_trivially_copyable<tvalue>::value, "");
+
+        ///
+        /// \brief constructor
+        ///
+        explicit tpool_deque_t(const int64_t log2_capacity = 8)
+        {
+            m_buffers.push_back(std::make_unique<buffer_t>(log2_capacity));
+            m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+        }
+
+        ///
+        /// \brief disable copying
+        ///
+        tpool_deque_t(const tpool_deque_t&) = delete;
+        tpool_deque_t& operator=(const tpool_deque_t&) = delete;
+
+        ///
+        /// \brief disable moving
+        ///
+        tpool_deque_t(tpool_deque_t&&) = delete;
+        tpool_deque_t& operator=(tpool_deque_t&&) = delete;
+
+        ///
+        /// \brief destructor
+        ///
+        ~tpool_deque_t() = default;
+
+        ///
+        /// \brief push a new element at the bottom (only the owner thread can call this)
+        ///
+        void push(const tvalue value)
+        {
+            const auto b = m_bottom.load(std::memory_order_relaxed);
+            const auto t = m_top.load(std::memory_order_acquire);
+
+            auto* buffer = m_buffer.load(std::memory_order_relaxed);
+            if (b - t > buffer->capacity() - 1)
+            {
+                buffer = grow(buffer, t, b);
+            }
+
+            buffer->put(b, value);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        ///
+        /// \brief pop an element from the bottom (only the owner thread can call this)
+        ///
+        bool pop(tvalue& value)
+        {
+            const auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+            auto* buffer = m_buffer.load(std::memory_order_relaxed);
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            auto t = m_top.load(std::memory_order_relaxed);
+            if (t > b)
+            {
+                // empty deque
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            value = buffer->get(b);
+            if (t == b)
+            {
+                // last element: race against the thieves
+                const auto won = m_top.compare_exchange_strong(t, t + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+
+            return true;
+        }
+
+        ///
+        /// \brief steal an element from the top (any thread can call this)
+        ///
+        bool steal(tvalue& value)
+        {
+            auto t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const auto b = m_bottom.load(std::memory_order_acquire);
+
+            if (t >= b)
+            {
+                return false;
+            }
+
+            const auto* buffer = m_buffer.load(std::memory_order_acquire);
+            value = buffer->get(t);
+            return m_top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+        ///
+        /// \brief check if the deque is (approximately) empty
+        ///
+        bool empty() const
+        {
+            const auto b = m_bottom.load(std::memory_order_relaxed);
+            const auto t = m_top.load(std::memory_order_relaxed);
+            return b <= t;
+        }
+
+    private:
+
+        struct buffer_t
+        {
+            explicit buffer_t(const int64_t log2_capacity) :
+                m_mask((int64_t(1) << log2_capacity) - 1),
+                m_log2_capacity(log2_capacity),
+                m_values(new std::atomic<tvalue>[static_cast<size_t>(int64_t(1) << log2_capacity)])
+            {
+            }
+
+            int64_t capacity() const { return m_mask + 1; }
+            int64_t log2_capacity() const { return m_log2_capacity; }
+
+            tvalue get(const int64_t index) const
+            {
+                return m_values[index & m_mask].load(std::memory_order_relaxed);
+            }
+
+            void put(const int64_t index, const tvalue value)
+            {
+                m_values[index & m_mask].store(value, std::memory_order_relaxed);
+            }
+
+            // attributes
+            int64_t                                 m_mask{0};              ///<
+            int64_t                                 m_log2_capacity{0};     ///<
+            std::unique_ptr<std::atomic<tvalue>[]>  m_values;               ///<
+        };
+
+        buffer_t* grow(const buffer_t* buffer, const int64_t t, const int64_t b)
+        {
+            m_buffers.push_back(std::make_unique<buffer_t>(buffer->log2_capacity() + 1));
+
+            auto* new_buffer = m_buffers.back().get();
+            for (auto i = t; i < b; ++ i)
+            {
+                new_buffer->put(i, buffer->get(i));
+            }
+
+            m_buffer.store(new_buffer, std::memory_order_release);
+            return new_buffer;
+        }
+
+        // attributes
+        std::atomic<int64_t>                    m_top{0};           ///< index of the next element to steal
+        std::atomic<int64_t>                    m_bottom{0};        ///< index of the next element to push
+        std::atomic<buffer_t*>                  m_buffer{nullptr};  ///< current circular buffer
+        std::vector<std::unique_ptr<buffer_t>>  m_buffers;          ///< all buffers allocated so far (owner only)
+    };
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <new>
+#include <mutex>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <condition_variable>
+
+namespace nano
+{
+    ///
+    /// \brief count down the number of tasks to finish (aka latch).
+    ///     the first exception thrown by the associated tasks (if any) is kept to be rethrown when waiting.
+    ///
+    class tpool_latch_t
+    {
+    public:
+        ///
+        /// \brief constructor
+        ///
+        explicit tpool_latch_t(const size_t count = 0) : m_count(count) {}
+
+        ///
+        /// \brief disable copying
+        ///
+        tpool_latch_t(const tpool_latch_t&) = delete;
+        tpool_latch_t& operator=(const tpool_latch_t&) = delete;
+
+        ///
+        /// \brief disable moving
+        ///
+        tpool_latch_t(tpool_latch_t&&) = delete;
+        tpool_latch_t& operator=(tpool_latch_t&&) = delete;
+
+        ///
+        /// \brief destructor
+        ///
+        ~tpool_latch_t() = default;
+
+        ///
+        /// \brief increase the number of tasks to wait for
+        ///
+        void add(const size_t count = 1)
+        {
+            m_count.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        ///
+        /// \brief signal that a task is done
+        ///
+        void count_down()
+        {
+            // fast path: not the last task, so nobody to notify
+            auto count = m_count.load(std::memory_order_relaxed);
+            while (count > 1)
+            {
+                if (m_count.compare_exchange_weak(count, count - 1,
+                    std::memory_order_acq_rel, std::memory_order_relaxed))
+                {
+                    return;
+                }
+            }
+
+            // slow path: the last task, so notify the waiting thread
+            // NB: the mutex is held to make sure the latch is not destroyed while notifying!
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_count.fetch_sub(1, std::memory_order_acq_rel);
+            m_condition.notify_all();
+        }
+
+        ///
+        /// \brief signal that a task has failed with the given exception
+        ///
+        void count_down(std::exception_ptr exception)
+        {
+            {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_exception)
+                {
+                    m_exception = std::move(exception);
+                }
+            }
+            count_down();
+        }
+
+        ///
+        /// \brief check if all tasks are done
+        ///
+        bool done() const
+        {
+            return m_count.load(std::memory_order_acquire) == 0;
+        }
+
+        ///
+        /// \brief block until all tasks are done
+        ///
+        void wait() const
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [&] { return done(); });
+        }
+
+        ///
+        /// \brief block until all tasks are done or the given timeout expires, returns true if all tasks are done
+        ///
+        template <typename tduration>
+        bool wait_for(const tduration& timeout) const
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            return m_condition.wait_for(lock, timeout, [&] { return done(); });
+        }
+
+        ///
+        /// \brief rethrow the first exception thrown by the tasks (if any)
+        ///
+        void rethrow()
+        {
+            std::exception_ptr exception;
+            {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                std::swap(exception, m_exception);
+            }
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+
+    private:
+
+        // attributes
+        std::atomic<size_t>             m_count{0};     ///< number of tasks still running
+        mutable std::mutex              m_mutex;        ///< synchronization
+        mutable std::condition_variable m_condition;    ///< signaling
+        std::exception_ptr              m_exception;    ///< first exception thrown by the tasks (if any)
+    };
+
+    ///
+    /// \brief fire-and-forget task using a small-buffer optimization to store the callable object.
+    ///     the associated latch (if any) is signaled when the task is done.
+    ///
+    /// NB: the callable objects larger than the inline buffer are allocated on the heap.
+    ///
+    class tpool_task_t
+    {
+    public:
+
+        static constexpr size_t capacity = 64;
+
+        ///
+        /// \brief constructor
+        ///
+        tpool_task_t() = default;
+
+        ///
+        /// \brief disable copying
+        ///
+        tpool_task_t(const tpool_task_t&) = delete;
+        tpool_task_t& operator=(const tpool_task_t&) = delete;
+
+        ///
+        /// \brief disable moving
+        ///
+        tpool_task_t(tpool_task_t&&) = delete;
+        tpool_task_t& operator=(tpool_task_t&&) = delete;
+
+        ///
+        /// \brief destructor
+        ///
+        ~tpool_task_t()
+        {
+            reset();
+        }
+
+        ///
+        /// \brief set the callable object to run and the latch to signal
+        ///
+        template <typename tfunction>
+        void assign(tfunction&& f, tpool_latch_t* latch)
+        {
+            using tcallable = std::decay_t<tfunction>;
+            using tinline = std::integral_constant<bool,
+                sizeof(tcallable) <= capacity && alignof(tcallable) <= alignof(storage_t)>;
+
+            assert(m_invoke == nullptr);
+            m_latch = latch;
+            store<tcallable>(std::forward<tfunction>(f), tinline{});
+        }
+
+        ///
+        /// \brief execute the task, release the callable object and then signal the latch (if any)
+        ///
+        void operator()()
+        {
+            assert(m_invoke != nullptr);
+
+            std::exception_ptr exception;
+            try
+            {
+                m_invoke(&m_storage);
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+
+            auto* latch = m_latch;
+            reset();
+
+            if (latch != nullptr)
+            {
+                exception ? latch->count_down(std::move(exception)) : latch->count_down();
+            }
+        }
+
+        ///
+        /// \brief release the callable object (if any) without executing it
+        ///
+        void reset()
+        {
+            if (m_destroy != nullptr)
+            {
+                m_destroy(&m_storage);
+            }
+            m_invoke = nullptr;
+            m_destroy = nullptr;
+            m_latch = nullptr;
+        }
+
+    private:
+
+        friend class tpool_arena_t;
+
+        template <typename tcallable, typename tfunction>
+        void store(tfunction&& f, std::true_type)
+        {
+            new (&m_storage) tcallable(std::forward<tfunction>(f));
+            m_invoke = [] (void* storage) { (*static_cast<tcallable*>(storage))(); };
+            m_destroy = [] (void* storage) { static_cast<tcallable*>(storage)->~tcallable(); };
+        }
+
+        template <typename tcallable, typename tfunction>
+        void store(tfunction&& f, std::false_type)
+        {
+            new (&m_storage) tcallable*(new tcallable(std::forward<tfunction>(f)));
+            m_invoke = [] (void* storage) { (**static_cast<tcallable**>(storage))(); };
+            m_destroy = [] (void* storage) { delete *static_cast<tcallable**>(storage); };
+        }
+
+        using storage_t = std::aligned_storage_t<capacity, alignof(std::max_align_t)>;
+        using function_t = void (*)(void*);
+
+        // attributes
+        storage_t               m_storage;              ///< inline buffer to store the callable object
+        function_t              m_invoke{nullptr};      ///< type-erased call of the stored callable
+        function_t              m_destroy{nullptr};     ///< type-erased destruction of the stored callable
+        tpool_latch_t*          m_latch{nullptr};       ///< latch to signal when done (if any)
+        std::atomic<uint32_t>   m_next{0};              ///< next free task (see tpool_arena_t)
+        bool                    m_heap{false};          ///< allocated on the heap because the arena was full
+    };
+
+    ///
+    /// \brief preallocated storage of tasks recycled using a lock-free free-list,
+    ///     so that no heap allocation is performed when enqueueing tasks in the steady state.
+    ///
+    /// NB: the free-list head is tagged with a counter to avoid the ABA problem.
+    /// NB: the tasks are allocated on the heap when the arena is full.
+    ///
+    class tpool_arena_t
+    {
+    public:
+        ///
+        /// \brief constructor
+        ///
+        explicit tpool_arena_t(const size_t size = 1024) :
+            m_tasks(std::make_unique<tpool_task_t[]>(size)),
+            m_size(size)
+        {
+            assert(size > 0 && size < std::numeric_limits<uint32_t>::max());
+
+            for (size_t i = 0; i + 1 < size; ++ i)
+            {
+                m_tasks[i].m_next.store(static_cast<uint32_t>(i + 2), std::memory_order_relaxed);
+            }
+            m_head.store(1, std::memory_order_relaxed);
+        }
+
+        ///
+        /// \brief disable copying
+        ///
+        tpool_arena_t(const tpool_arena_t&) = delete;
+        tpool_arena_t& operator=(const tpool_arena_t&) = delete;
+
+        ///
+        /// \brief disable moving
+        ///
+        tpool_arena_t(tpool_arena_t&&) = delete;
+        tpool_arena_t& operator=(tpool_arena_t&&) = delete;
+
+        ///
+        /// \brief destructor
+        ///
+        ~tpool_arena_t() = default;
+
+        ///
+        /// \brief retrieve an unused task
+        ///
+        tpool_task_t* acquire()
+        {
+            auto head = m_head.load(std::memory_order_acquire);
+            while (true)
+            {
+                const auto index = static_cast<uint32_t>(head & mask);
+                if (index == 0)
+                {
+                    auto* task = new tpool_task_t();
+                    task->m_heap = true;
+                    return task;
+                }
+
+                const auto next = m_tasks[index - 1].m_next.load(std::memory_order_relaxed);
+                if (m_head.compare_exchange_weak(head, retag(head, next),
+                    std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    return &m_tasks[index - 1];
+                }
+            }
+        }
+
+        ///
+        /// \brief recycle the given task
+        ///
+        void release(tpool_task_t* task)
+        {
+            assert(task != nullptr);
+
+            if (task->m_heap)
+            {
+                delete task;
+                return;
+            }
+
+            assert(task >= &m_tasks[0] && task < &m_tasks[0] + m_size);
+            const auto index = static_cast<uint64_t>(task - &m_tasks[0]) + 1;
+
+            auto head = m_head.load(std::memory_order_relaxed);
+            do
+            {
+                task->m_next.store(static_cast<uint32_t>(head & mask), std::memory_order_relaxed);
+            }
+            while (!m_head.compare_exchange_weak(head, retag(head, index),
+                std::memory_order_release, std::memory_order_relaxed));
+        }
+
+    private:
+
+        static constexpr uint64_t mask = 0xFFFFFFFF;
+
+        static uint64_t retag(const uint64_t head, const uint64_t index)
+        {
+            return (((head >> 32) + 1) << 32) | index;
+        }
+
+        // attributes
+        std::unique_ptr<tpool_task_t[]> m_tasks;        ///< preallocated tasks
+        size_t                          m_size{0};      ///< number of preallocated tasks
+        std::atomic<uint64_t>           m_head{0};      ///< tagged index (plus one) of the first free task
+    };
+}
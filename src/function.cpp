@@ -1,3 +1,5 @@
+#include <nano/tpool.h>
+#include <nano/random.h>
 #include <nano/function.h>
 #include <nano/function/trid.h>
 #include <nano/function/qing.h>
@@ -33,6 +35,79 @@ function_t::function_t(string_t name, const tensor_size_t size, const convexity
 {
 }
 
+bool function_t::vdir(const vector_t&, const vector_t&, scalar_t&, scalar_t&) const
+{
+    return false;
+}
+
+bool function_t::line_coeffs(const vector_t&, const vector_t&, vector_t&) const
+{
+    return false;
+}
+
+scalar_t function_t::line_vgrad(const vector_t& coeffs, const scalar_t t, scalar_t& dphi) const
+{
+    // NB: Horner's scheme for p(t) = sum(c_k * t^k, k=0,K) and its derivative,
+    //  so that phi(t) - phi(0) = t * p(t) and phi'(t) = p(t) + t * p'(t).
+    scalar_t p = 0, dp = 0;
+    for (auto k = coeffs.size() - 1; k >= 0; -- k)
+    {
+        dp = dp * t + p;
+        p = p * t + coeffs(k);
+    }
+
+    dphi = p + t * dp;
+    return t * p;
+}
+
+void function_t::hvprod(const vector_t& x, const vector_t& v, vector_t& Hv) const
+{
+    if (!hvprod_analytic(x, v, Hv))
+    {
+        hvprod_approx(x, v, Hv);
+    }
+}
+
+bool function_t::hvprod_analytic(const vector_t&, const vector_t&, vector_t&) const
+{
+    return false;
+}
+
+void function_t::hvprod_approx(const vector_t& x, const vector_t& v, vector_t& Hv) const
+{
+    assert(x.size() == size());
+    assert(v.size() == size());
+
+    Hv.resize(size());
+
+    const auto vnorm = v.lpNorm<Eigen::Infinity>();
+    if (vnorm < std::numeric_limits<scalar_t>::min())
+    {
+        Hv.setZero();
+        return;
+    }
+
+    // NB: the step is scaled so that the perturbation is relative to the magnitude of x
+    const auto dt = epsilon2<scalar_t>() * (1 + x.lpNorm<Eigen::Infinity>()) / vnorm;
+
+    vector_t xt = x + dt * v;
+    vector_t gn(size());
+
+    vgrad(xt, &Hv);
+    xt = x - dt * v;
+    vgrad(xt, &gn);
+
+    Hv -= gn;
+    Hv /= 2 * dt;
+}
+
+static tensor_size_t grad_accuracy_chunk(const tensor_size_t n)
+{
+    // NB: each finite difference costs 2 function calls of O(n), so group them in chunks
+    //  of at least ~8K operations to amortize the scheduling (all at once for small problems)
+    return std::max(tensor_size_t(1), tensor_size_t(8192) / std::max(n, tensor_size_t(1)));
+}
+
 scalar_t function_t::grad_accuracy(const vector_t& x) const
 {
     assert(x.size() == size());
@@ -41,7 +116,6 @@ scalar_t function_t::grad_accuracy(const vector_t& x) const
 
     vector_t gx(n);
     vector_t gx_approx(n);
-    vector_t xp = x, xn = x;
 
     // analytical gradient
     const auto fx = vgrad(x, &gx);
@@ -49,25 +123,128 @@ scalar_t function_t::grad_accuracy(const vector_t& x) const
 
     // finite-difference approximated gradient
     //      see "Numerical optimization", Nocedal & Wright, 2nd edition, p.197
-    const auto finite_difference = [&] (const scalar_t dx)
+    // NB: each thread perturbs in place (and then restores) one coordinate at a time of its own copy of x
+    auto& pool = tpool_t::instance();
+    std::vector<vector_t> xbuffers(pool.workers(), x);
+
+    const auto dx = epsilon2<scalar_t>();
+    const auto op = [&] (const tensor_size_t begin, const tensor_size_t end, const tensor_size_t tnum)
     {
-        for (auto i = 0; i < n; i ++)
+        auto& xt = xbuffers[static_cast<size_t>(tnum)];
+        for (auto i = begin; i < end; ++ i)
         {
-            xp = x; xp(i) += dx * (1 + std::fabs(x(i)));
-            xn = x; xn(i) -= dx * (1 + std::fabs(x(i)));
+            const auto xi = x(i);
 
-            const auto dfi = vgrad(xp, nullptr) - vgrad(xn, nullptr);
-            const auto dxi = xp(i) - xn(i);
-            gx_approx(i) = dfi / dxi;
+            xt(i) = xi + dx * (1 + std::fabs(xi));
+            const auto xpi = xt(i);
+            const auto fp = vgrad(xt, nullptr);
+
+            xt(i) = xi - dx * (1 + std::fabs(xi));
+            const auto xni = xt(i);
+            const auto fn = vgrad(xt, nullptr);
+
+            xt(i) = xi;
+            gx_approx(i) = (fp - fn) / (xpi - xni);
 
             assert(std::isfinite(gx(i)));
             assert(std::isfinite(gx_approx(i)));
         }
+    };
+
+    const auto chunk = grad_accuracy_chunk(n);
+    if (chunk < n)
+    {
+        loopr(pool, n, chunk, op, tpool_schedule::dynamic);
+    }
+    else
+    {
+        op(0, n, 0);
+    }
 
-        return (gx - gx_approx).lpNorm<Eigen::Infinity>() / (1 + std::fabs(fx));
+    return (gx - gx_approx).lpNorm<Eigen::Infinity>() / (1 + std::fabs(fx));
+}
+
+scalar_t function_t::grad_accuracy(const vector_t& x, const tensor_size_t directions, const uint32_t seed) const
+{
+    assert(x.size() == size());
+    assert(directions > 0);
+
+    const auto n = size();
+
+    vector_t gx(n);
+
+    // analytical gradient
+    const auto fx = vgrad(x, &gx);
+    assert(gx.size() == size());
+
+    // random unit directions (reproducible for the given seed)
+    auto rng = rng_t{seed};
+    matrix_t D(directions, n);
+    urand(scalar_t(-1), scalar_t(+1), D.data(), D.data() + D.size(), rng);
+    D.rowwise().normalize();
+
+    // finite-difference approximated directional derivatives
+    auto& pool = tpool_t::instance();
+    std::vector<vector_t> xbuffers(pool.workers(), vector_t(n));
+
+    // NB: the step balances the truncation and the rounding errors of the central finite differences
+    const auto dt = epsilon3<scalar_t>() * (1 + x.lpNorm<Eigen::Infinity>());
+
+    vector_t errors(directions);
+    const auto op = [&] (const tensor_size_t begin, const tensor_size_t end, const tensor_size_t tnum)
+    {
+        auto& xt = xbuffers[static_cast<size_t>(tnum)];
+        for (auto k = begin; k < end; ++ k)
+        {
+            xt = x + dt * D.row(k).transpose();
+            const auto fp = vgrad(xt, nullptr);
+
+            xt = x - dt * D.row(k).transpose();
+            const auto fn = vgrad(xt, nullptr);
+
+            const auto dg = gx.dot(D.row(k));
+            const auto dg_approx = (fp - fn) / (2 * dt);
+
+            assert(std::isfinite(dg));
+            assert(std::isfinite(dg_approx));
+
+            errors(k) = std::fabs(dg - dg_approx);
+        }
     };
 
-    return finite_difference(epsilon2<scalar_t>());
+    const auto chunk = grad_accuracy_chunk(n);
+    if (chunk < directions)
+    {
+        loopr(pool, directions, chunk, op, tpool_schedule::dynamic);
+    }
+    else
+    {
+        op(0, directions, 0);
+    }
+
+    return errors.lpNorm<Eigen::Infinity>() / (1 + std::fabs(fx));
+}
+
+void function_t::vgrad_batch(matrix_cmap_t X, vector_map_t f, matrix_map_t G) const
+{
+    assert(X.cols() == size());
+    assert(f.size() == X.rows());
+    assert(G.size() == 0 || (G.rows() == X.rows() && G.cols() == size()));
+
+    vector_t x(size()), gx(size());
+    for (tensor_size_t i = 0; i < X.rows(); ++ i)
+    {
+        x = X.row(i).transpose();
+        if (G.size() > 0)
+        {
+            f(i) = vgrad(x, &gx);
+            G.row(i) = gx.transpose();
+        }
+        else
+        {
+            f(i) = vgrad(x, nullptr);
+        }
+    }
 }
 
 bool function_t::is_convex(const vector_t& x1, const vector_t& x2, const int steps) const
@@ -82,16 +259,35 @@ bool function_t::is_convex(const vector_t& x1, const vector_t& x2, const int ste
     const auto f2 = vgrad(x2, nullptr);
     assert(std::isfinite(f2));
 
-    for (int step = 1; step < steps; step ++)
+    // NB: the intermediate points are evaluated in small batches reusing the same buffer,
+    //  so that the memory does not grow with the number of steps
+    const auto batch = std::min(steps - 1, 8);
+
+    matrix_t X(batch, size());
+    vector_t f(batch);
+    for (int begin = 1; begin < steps; begin += batch)
     {
-        const auto t1 = scalar_t(step) / scalar_t(steps);
-        const auto t2 = scalar_t(1) - t1;
-        const auto ftc = t1 * f1 + t2 * f2;
+        const auto count = std::min(batch, steps - begin);
+        for (int k = 0; k < count; ++ k)
+        {
+            const auto t1 = scalar_t(begin + k) / scalar_t(steps);
+            const auto t2 = scalar_t(1) - t1;
+            X.row(k) = t1 * x1.transpose() + t2 * x2.transpose();
+        }
 
-        const auto ft = vgrad(t1 * x1 + t2 * x2, nullptr);
-        if (std::isfinite(ft) && ft > ftc + epsilon0<scalar_t>())
+        vgrad_batch(matrix_cmap_t(X.data(), count, size()), map_vector(f.data(), count), matrix_map_t(nullptr, 0, 0));
+
+        for (int k = 0; k < count; ++ k)
         {
-            return false;
+            const auto t1 = scalar_t(begin + k) / scalar_t(steps);
+            const auto t2 = scalar_t(1) - t1;
+            const auto ftc = t1 * f1 + t2 * f2;
+
+            const auto ft = f(k);
+            if (std::isfinite(ft) && ft > ftc + epsilon0<scalar_t>())
+            {
+                return false;
+            }
         }
     }
 
@@ -0,0 +1,244 @@
+#include <nano/linear.h>
+
+using namespace nano;
+
+static tensor_size_t dataset_osize(const dataset_t& dataset)
+{
+    const auto feature = dataset.tfeature();
+    return  feature.discrete() ?
+            static_cast<tensor_size_t>(feature.labels().size()) :
+            tensor_size_t(1);
+}
+
+static tensor_size_t dataset_isize(const dataset_t& dataset)
+{
+    return static_cast<tensor_size_t>(dataset.ifeatures());
+}
+
+linear_function_t::linear_function_t(dataset_t& dataset, const fold_t& fold, const loss_t& loss, const scalar_t lambda) :
+    stoch_function_t("linear", (dataset_isize(dataset) + 1) * dataset_osize(dataset), convexity::unknown),
+    m_dataset(dataset),
+    m_fold(fold),
+    m_loss(loss),
+    m_lambda(lambda)
+{
+    if (lambda < 0)
+    {
+        throw std::invalid_argument("linear function: invalid regularization factor, expecting non-negative");
+    }
+
+    load();
+}
+
+void linear_function_t::load()
+{
+    const auto inputs = m_dataset.inputs(m_fold);
+    const auto targets = m_dataset.targets(m_fold);
+
+    const auto samples = inputs.size<0>();
+    if (inputs.size() != samples * dataset_isize(m_dataset) || targets.size() != samples * dataset_osize(m_dataset))
+    {
+        throw std::invalid_argument("linear function: invalid dataset, expecting scalar input and target features");
+    }
+
+    m_inputs = map_matrix(inputs.data(), samples, dataset_isize(m_dataset));
+    m_inputs = m_inputs.unaryExpr([] (const scalar_t value) { return std::isfinite(value) ? value : scalar_t(0); });
+
+    m_targets = map_matrix(targets.data(), samples, dataset_osize(m_dataset));
+}
+
+void linear_function_t::shuffle()
+{
+    m_dataset.shuffle(m_fold);
+    load();
+}
+
+scalar_t linear_function_t::vgrad(const vector_t& x, vector_t* gx) const
+{
+    return vgrad(x, 0, samples(), gx);
+}
+
+scalar_t linear_function_t::vgrad(const vector_t& x, const tensor_size_t begin, const tensor_size_t end,
+    vector_t* gx) const
+{
+    assert(x.size() == size());
+    assert(0 <= begin && begin < end && end <= samples());
+
+    const auto count = end - begin;
+    const auto W = map_matrix(x.data(), osize(), isize());
+    const auto b = map_vector(x.data() + W.size(), osize());
+
+    const auto inputs = m_inputs.middleRows(begin, count);
+    const auto targets = m_targets.middleRows(begin, count);
+
+    matrix_t outputs = inputs * W.transpose();
+    outputs.rowwise() += b.transpose();
+
+    matrix_t vgrads(gx ? count : 0, osize());
+
+    scalar_t fx = 0;
+    for (tensor_size_t i = 0; i < count; ++ i)
+    {
+        const auto target = map_tensor(targets.row(i).data(), osize(), 1, 1);
+        const auto output = map_tensor(outputs.row(i).data(), osize(), 1, 1);
+
+        fx += m_loss.value(target, output);
+        if (gx)
+        {
+            m_loss.vgrad(target, output, map_tensor(vgrads.row(i).data(), osize(), 1, 1));
+        }
+    }
+
+    if (gx)
+    {
+        gx->resize(size());
+        map_matrix(gx->data(), osize(), isize()).noalias() =
+            vgrads.transpose() * inputs / count + m_lambda * W;
+        map_vector(gx->data() + W.size(), osize()) =
+            vgrads.colwise().sum().transpose() / count;
+    }
+
+    return fx / count + scalar_t(0.5) * m_lambda * W.squaredNorm();
+}
+
+bool linear_function_t::vdir(const vector_t& x, const vector_t& d, scalar_t& fx, scalar_t& dg) const
+{
+    assert(x.size() == size());
+    assert(d.size() == size());
+
+    const auto count = samples();
+    const auto W = map_matrix(x.data(), osize(), isize());
+    const auto b = map_vector(x.data() + W.size(), osize());
+    const auto DW = map_matrix(d.data(), osize(), isize());
+    const auto db = map_vector(d.data() + W.size(), osize());
+
+    // NB: outputs = [inputs * W' + b, inputs * DW' + db]
+    matrix_t WD(2 * osize(), isize());
+    WD.topRows(osize()) = W;
+    WD.bottomRows(osize()) = DW;
+
+    matrix_t outputs = m_inputs * WD.transpose();
+    outputs.leftCols(osize()).rowwise() += b.transpose();
+    outputs.rightCols(osize()).rowwise() += db.transpose();
+
+    vector_t output(osize()), vgrad(osize());
+
+    fx = dg = 0;
+    for (tensor_size_t i = 0; i < count; ++ i)
+    {
+        const auto target = map_tensor(m_targets.row(i).data(), osize(), 1, 1);
+        output = outputs.row(i).head(osize()).transpose();
+        const auto toutput = map_tensor(output.data(), osize(), 1, 1);
+
+        fx += m_loss.value(target, toutput);
+        m_loss.vgrad(target, toutput, map_tensor(vgrad.data(), osize(), 1, 1));
+        dg += vgrad.dot(outputs.row(i).tail(osize()).transpose());
+    }
+
+    fx = fx / count + scalar_t(0.5) * m_lambda * W.squaredNorm();
+    dg = dg / count + m_lambda * W.cwiseProduct(DW).sum();
+    return true;
+}
+
+bool linear_function_t::line_coeffs(const vector_t& x, const vector_t& d, vector_t& coeffs) const
+{
+    assert(x.size() == size());
+    assert(d.size() == size());
+
+    // NB: the coefficients are stored as [outputs, outputs' change along d, loss(0), W.dot(DW), DW.dot(DW)]
+    const auto count = samples();
+    const auto W = map_matrix(x.data(), osize(), isize());
+    const auto b = map_vector(x.data() + W.size(), osize());
+    const auto DW = map_matrix(d.data(), osize(), isize());
+    const auto db = map_vector(d.data() + W.size(), osize());
+
+    coeffs.resize(2 * count * osize() + 3);
+    auto outputs = map_matrix(coeffs.data(), count, osize());
+    auto doutputs = map_matrix(coeffs.data() + outputs.size(), count, osize());
+
+    outputs.noalias() = m_inputs * W.transpose();
+    outputs.rowwise() += b.transpose();
+    doutputs.noalias() = m_inputs * DW.transpose();
+    doutputs.rowwise() += db.transpose();
+
+    scalar_t loss0 = 0;
+    for (tensor_size_t i = 0; i < count; ++ i)
+    {
+        const auto target = map_tensor(m_targets.row(i).data(), osize(), 1, 1);
+        const auto output = map_tensor(outputs.row(i).data(), osize(), 1, 1);
+        loss0 += m_loss.value(target, output);
+    }
+
+    coeffs(2 * count * osize() + 0) = loss0 / count;
+    coeffs(2 * count * osize() + 1) = W.cwiseProduct(DW).sum();
+    coeffs(2 * count * osize() + 2) = DW.squaredNorm();
+    return true;
+}
+
+scalar_t linear_function_t::line_vgrad(const vector_t& coeffs, const scalar_t t, scalar_t& dphi) const
+{
+    const auto count = samples();
+    assert(coeffs.size() == 2 * count * osize() + 3);
+
+    const auto outputs = map_matrix(coeffs.data(), count, osize());
+    const auto doutputs = map_matrix(coeffs.data() + outputs.size(), count, osize());
+    const auto loss0 = coeffs(2 * count * osize() + 0);
+    const auto wd = coeffs(2 * count * osize() + 1);
+    const auto dd = coeffs(2 * count * osize() + 2);
+
+    vector_t output(osize()), vgrad(osize());
+
+    scalar_t fx = 0;
+    dphi = 0;
+    for (tensor_size_t i = 0; i < count; ++ i)
+    {
+        const auto target = map_tensor(m_targets.row(i).data(), osize(), 1, 1);
+        const auto toutput = map_tensor(output.data(), osize(), 1, 1);
+
+        output = (outputs.row(i) + t * doutputs.row(i)).transpose();
+        fx += m_loss.value(target, toutput);
+        m_loss.vgrad(target, toutput, map_tensor(vgrad.data(), osize(), 1, 1));
+        dphi += vgrad.dot(doutputs.row(i).transpose());
+    }
+
+    dphi = dphi / count + m_lambda * (wd + t * dd);
+    return fx / count - loss0 + m_lambda * t * (wd + t * dd / 2);
+}
+
+scalar_t linear_function_t::sgrad_i(const vector_t& x, const tensor_size_t i, vector_t& s) const
+{
+    assert(x.size() == size());
+    assert(0 <= i && i < samples());
+
+    const auto W = map_matrix(x.data(), osize(), isize());
+    const auto b = map_vector(x.data() + W.size(), osize());
+
+    const vector_t output = W * m_inputs.row(i).transpose() + b;
+
+    const auto target = map_tensor(m_targets.row(i).data(), osize(), 1, 1);
+    const auto toutput = map_tensor(output.data(), osize(), 1, 1);
+
+    s.resize(osize());
+    m_loss.vgrad(target, toutput, map_tensor(s.data(), osize(), 1, 1));
+
+    return m_loss.value(target, toutput) + scalar_t(0.5) * m_lambda * W.squaredNorm();
+}
+
+void linear_function_t::expand_i(const tensor_size_t i, const vector_t& s, const scalar_t alpha, vector_t& g) const
+{
+    assert(g.size() == size());
+    assert(s.size() == osize());
+    assert(0 <= i && i < samples());
+
+    map_matrix(g.data(), osize(), isize()).noalias() += alpha * s * m_inputs.row(i);
+    map_vector(g.data() + osize() * isize(), osize()) += alpha * s;
+}
+
+void linear_function_t::rgrad(const vector_t& x, vector_t& g) const
+{
+    assert(x.size() == size());
+    assert(g.size() == size());
+
+    const auto size = osize() * isize();
+    g.segment(0, size) += m_lambda * x.segment(0, size);
+}
@@ -23,6 +23,11 @@ void lsearch0_cgdescent_t::config(const json_t& json)
     from_json_range(json, "phi2", m_phi2, 1 + eps, inf);
 }
 
+rlsearch0_t lsearch0_cgdescent_t::clone() const
+{
+    return std::make_unique<lsearch0_cgdescent_t>(*this);
+}
+
 scalar_t lsearch0_cgdescent_t::get(const solver_state_t& state)
 {
     scalar_t t0;
@@ -52,11 +57,11 @@ scalar_t lsearch0_cgdescent_t::get(const solver_state_t& state)
             0, state.f, state.dg()
         };
 
+        // NB: the line-search length is from the previous iteration!
         lsearch_step_t stepx
         {
             state.t * m_phi1,
-            // NB: the line-search length is from the previous iteration!
-            state.function->vgrad(state.x + state.t * m_phi1 * state.d),
+            value(state, state.t * m_phi1, m_x),
             0
         };
 
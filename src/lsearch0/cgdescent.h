@@ -15,6 +15,7 @@ namespace nano
 
         json_t config() const final;
         void config(const json_t&) final;
+        rlsearch0_t clone() const final;
         scalar_t get(const solver_state_t&) final;
 
     private:
@@ -23,5 +24,6 @@ namespace nano
         scalar_t    m_phi0{static_cast<scalar_t>(0.01)};    ///<
         scalar_t    m_phi1{static_cast<scalar_t>(0.1)};     ///<
         scalar_t    m_phi2{static_cast<scalar_t>(2.0)};     ///<
+        vector_t    m_x;                                    ///< buffer to evaluate the trial point
     };
 }
@@ -19,6 +19,11 @@ void lsearch0_constant_t::config(const json_t& json)
     from_json_range(json, "t0", m_t0, eps, inf);
 }
 
+rlsearch0_t lsearch0_constant_t::clone() const
+{
+    return std::make_unique<lsearch0_constant_t>(*this);
+}
+
 scalar_t lsearch0_constant_t::get(const solver_state_t& state)
 {
     log(state, m_t0);
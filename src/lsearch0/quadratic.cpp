@@ -21,6 +21,11 @@ void lsearch0_quadratic_t::config(const json_t& json)
     from_json_range(json, "beta", m_beta, 1 + eps, inf);
 }
 
+rlsearch0_t lsearch0_quadratic_t::clone() const
+{
+    return std::make_unique<lsearch0_quadratic_t>(*this);
+}
+
 scalar_t lsearch0_quadratic_t::get(const solver_state_t& state)
 {
     scalar_t t0;
@@ -17,6 +17,7 @@ namespace nano
 
         json_t config() const final;
         void config(const json_t&) final;
+        rlsearch0_t clone() const final;
         scalar_t get(const solver_state_t&) final;
 
     private:
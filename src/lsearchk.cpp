@@ -1,10 +1,12 @@
 #include <mutex>
 #include <nano/numeric.h>
+#include "lsearchk/exact.h"
 #include "lsearchk/fletcher.h"
 #include "lsearchk/backtrack.h"
 #include "lsearchk/cgdescent.h"
 #include "lsearchk/lemarechal.h"
 #include "lsearchk/morethuente.h"
+#include "lsearchk/parallel.h"
 
 using namespace nano;
 
@@ -20,6 +22,8 @@ lsearchk_factory_t& lsearchk_t::all()
         manager.add<lsearchk_lemarechal_t>("lemarechal", "LeMarechal (regular Wolfe conditions)");
         manager.add<lsearchk_morethuente_t>("morethuente", "More&Thuente (strong Wolfe conditions)");
         manager.add<lsearchk_fletcher_t>("fletcher", "Fletcher (strong Wolfe conditions)");
+        manager.add<lsearchk_exact_t>("exact", "exact line-search (closed-form or 1D minimization along the line)");
+        manager.add<lsearchk_parallel_t>("parallel", "speculative trials evaluated in parallel (strong Wolfe conditions)");
     });
 
     return manager;
@@ -32,22 +36,47 @@ static auto make_state0(const solver_state_t& state)
     return state0;
 }
 
-bool lsearchk_t::get(solver_state_t& state, scalar_t t)
+static void make_trial(const solver_state_t& state0, solver_state_t& state)
 {
+    // NB: the point and the gradient are overwritten by each trial, so they are not copied!
+    state.function = state0.function;
+    state.d = state0.d;
+    state.f = state0.f;
+    state.t = state0.t;
+    state.m_status = state0.m_status;
+    state.m_fcalls = state0.m_fcalls;
+    state.m_gcalls = state0.m_gcalls;
+    state.m_iterations = state0.m_iterations;
+}
+
+bool lsearchk_t::get(solver_state_t& state, const scalar_t t)
+{
+    const auto state0 = make_state0(state);
+    return get(state0, state, t);
+}
+
+bool lsearchk_t::get(const solver_state_t& state0, solver_state_t& state, scalar_t t)
+{
+    assert(state0.t < epsilon0<scalar_t>());
+
     // check descent direction
-    if (!state.has_descent())
+    if (!state0.has_descent())
     {
+        state = state0;
         return false;
     }
 
     // adjust the initial step length if it produces an invalid state
-    const auto state0 = make_state0(state);
-    assert(state0.t < epsilon0<scalar_t>());
+    make_trial(state0, state);
 
     t = std::isfinite(t) ? nano::clamp(t, stpmin(), scalar_t(1)) : scalar_t(1);
-    for (int i = 0; i < max_iterations(); ++ i)
+    // NB: some strategies evaluate the initial step length themselves (e.g. using the restriction to the line)
+    const auto evaluate = prepare(state0);
+
+    state.t = t;
+    for (int i = 0; evaluate && i < max_iterations(); ++ i)
     {
-        const auto ok = state.update(state0, t);
+        const auto ok = eval(state0, state, t);
         log(state0, state);
 
         if (!ok)
@@ -63,5 +92,14 @@ bool lsearchk_t::get(solver_state_t& state, scalar_t t)
     // line-search step length
     // NB: some line-search algorithms (see CGDESCENT) allow a small increase
     //     in the function value when close to numerical precision!
-    return get(state0, state) && state;
+    const auto ok = get(state0, state);
+
+    // NB: the intermediate trials may have evaluated only the directional derivative,
+    //     so the gradient is evaluated once at the accepted step
+    if (!state.has_gradient())
+    {
+        eval(state0, state, state.t);
+    }
+
+    return ok && state;
 }
@@ -14,6 +14,11 @@ void lsearchk_backtrack_t::config(const json_t& json)
     nano::from_json(json, "interpolation", m_interpolation);
 }
 
+rlsearchk_t lsearchk_backtrack_t::clone() const
+{
+    return std::make_unique<lsearchk_backtrack_t>(*this);
+}
+
 bool lsearchk_backtrack_t::get(const solver_state_t& state0, solver_state_t& state)
 {
     for (int i = 0; i < max_iterations() && state; ++ i)
@@ -24,7 +29,7 @@ bool lsearchk_backtrack_t::get(const solver_state_t& state0, solver_state_t& sta
         }
 
         // next trial
-        state.update(state0, lsearch_step_t::interpolate(state0, state, m_interpolation));
+        trial(state0, state, lsearch_step_t::interpolate(state0, state, m_interpolation));
         log(state0, state);
     }
 
@@ -146,7 +146,7 @@ lsearchk_cgdescent_t::status lsearchk_cgdescent_t::bracket(const solver_state_t&
 
 bool lsearchk_cgdescent_t::evaluate(const solver_state_t& state0, const scalar_t t, solver_state_t& c)
 {
-    const bool ok = c.update(state0, t);
+    const bool ok = trial(state0, c, t);
     log(state0, c);
 
     return ok && evaluate(state0, c);
@@ -185,6 +185,11 @@ bool lsearchk_cgdescent_t::evaluate(const solver_state_t& state0, const solver_s
     }
 }
 
+rlsearchk_t lsearchk_cgdescent_t::clone() const
+{
+    return std::make_unique<lsearchk_cgdescent_t>(*this);
+}
+
 bool lsearchk_cgdescent_t::get(const solver_state_t& state0, solver_state_t& state)
 {
     // estimate an upper bound of the function value
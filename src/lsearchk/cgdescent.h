@@ -33,6 +33,7 @@ namespace nano
 
         json_t config() const final;
         void config(const json_t&) final;
+        rlsearchk_t clone() const final;
         bool get(const solver_state_t& state0, solver_state_t& state) final;
 
     private:
@@ -0,0 +1,139 @@
+#include "exact.h"
+#include <nano/numeric.h>
+
+using namespace nano;
+
+json_t lsearchk_exact_t::config() const
+{
+    json_t json;
+    json["tolerance"] = strcat(m_tolerance, "(0,1)");
+    json["tau1"] = strcat(m_tau1, "(2,inf)");
+    return json;
+}
+
+void lsearchk_exact_t::config(const json_t& json)
+{
+    const auto eps = epsilon0<scalar_t>();
+    const auto inf = 1 / eps;
+
+    nano::from_json_range(json, "tolerance", m_tolerance, eps, 1 - eps);
+    nano::from_json_range(json, "tau1", m_tau1, 2 + eps, inf);
+}
+
+rlsearchk_t lsearchk_exact_t::clone() const
+{
+    return std::make_unique<lsearchk_exact_t>(*this);
+}
+
+bool lsearchk_exact_t::prepare(const solver_state_t& state0)
+{
+    // NB: the initial step length is evaluated only if the restriction to the line is not available
+    m_restricted = state0.function->line_coeffs(state0.x, state0.d, m_coeffs);
+    return !m_restricted;
+}
+
+bool lsearchk_exact_t::get(const solver_state_t& state0, solver_state_t& state)
+{
+    const auto& function = *state0.function;
+    const auto restricted = m_restricted;
+    const auto tolerance = restricted ? std::min(m_tolerance, c2()) : c2();
+
+    const auto f0 = state0.f;
+    const auto g0 = state0.dg();
+
+    const auto evaluate = [&] (const scalar_t t)
+    {
+        if (restricted)
+        {
+            scalar_t dphi = 0;
+            const auto dphi0 = function.line_vgrad(m_coeffs, t, dphi);
+            return lsearch_step_t{t, f0 + dphi0, dphi};
+        }
+        else
+        {
+            trial(state0, state, t);
+            log(state0, state);
+            return lsearch_step_t{state};
+        }
+    };
+
+    const auto has_armijo = [&] (const lsearch_step_t& step)
+    {
+        return step.f <= f0 + step.t * c1() * g0;
+    };
+
+    const auto converged = [&] (const lsearch_step_t& step, const scalar_t c)
+    {
+        return has_armijo(step) && std::fabs(step.g) <= c * std::fabs(g0);
+    };
+
+    // NB: the minimum is bracketed by lo (the lowest step satisfying the Armijo condition so far)
+    //  and hi (not satisfying the Armijo condition, larger function value or the derivative changes sign)
+    lsearch_step_t prev{0, f0, g0}, lo = prev, hi = prev;
+    lsearch_step_t step = restricted ? evaluate(state.t) : lsearch_step_t{state};
+
+    bool bracketed = false;
+    for (int i = 0; i < max_iterations() && !converged(step, tolerance); ++ i)
+    {
+        if (!std::isfinite(step.f) || !std::isfinite(step.g) || !has_armijo(step) || step.f >= lo.f)
+        {
+            hi = step;
+            bracketed = true;
+        }
+        else
+        {
+            if (bracketed ? (step.g * (hi.t - lo.t) >= 0) : (step.g >= 0))
+            {
+                hi = lo;
+                bracketed = true;
+            }
+            prev = lo;
+            lo = step;
+        }
+
+        scalar_t next;
+        if (!bracketed)
+        {
+            // extrapolate
+            next = lsearch_step_t::cubic(prev, lo);
+            next = std::isfinite(next) ? clamp(next, 1.1 * lo.t, m_tau1 * lo.t) : m_tau1 * lo.t;
+            next = std::min(next, stpmax());
+        }
+        else if (!std::isfinite(hi.f) || !std::isfinite(hi.g))
+        {
+            next = lsearch_step_t::bisection(lo, hi);
+        }
+        else
+        {
+            // zoom (NB: the cubic interpolation is exact for quadratic restrictions)
+            const auto tmin = std::min(lo.t, hi.t), tmax = std::max(lo.t, hi.t), delta = 0.01 * (tmax - tmin);
+            next = lsearch_step_t::interpolate(lo, hi, interpolation::cubic);
+            next = std::isfinite(next) ? clamp(next, tmin + delta, tmax - delta) : lsearch_step_t::bisection(lo, hi);
+        }
+
+        if (bracketed && std::fabs(hi.t - lo.t) <= epsilon0<scalar_t>() * std::max(hi.t, lo.t))
+        {
+            break;
+        }
+
+        step = evaluate(next);
+    }
+
+    // NB: fallback to the lowest step satisfying the Armijo condition if not converged
+    const auto t =
+        converged(step, c2()) ? step.t :
+        (lo.t > 0) ? lo.t : step.t;
+
+    if (restricted)
+    {
+        eval(state0, state, t);
+        log(state0, state);
+    }
+    else if (t != state.t)
+    {
+        trial(state0, state, t);
+        log(state0, state);
+    }
+
+    return state && state.has_armijo(state0, c1());
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <nano/lsearch/lsearchk.h>
+
+namespace nano
+{
+    ///
+    /// \brief exact line-search: the step length minimizes (approximately) the function along the descent direction,
+    ///     by bracketing and then zooming on the root of phi'(t) using cubic interpolation.
+    ///
+    /// NB: the restriction of the function to the line (see function_t::line_coeffs) is computed once per line-search
+    ///     if supported by the function (e.g. quadratic functions, linear models), so that the trials are cheap
+    ///     (closed-form for quadratic functions) and the step is refined until |phi'(t)| <= tolerance * |phi'(0)|.
+    ///     The function and its gradient are then evaluated only at the accepted step.
+    /// NB: otherwise the trials evaluate the function and the search stops at the strong Wolfe conditions.
+    ///
+    class lsearchk_exact_t final : public lsearchk_t
+    {
+    public:
+
+        lsearchk_exact_t() = default;
+
+        json_t config() const final;
+        void config(const json_t&) final;
+        rlsearchk_t clone() const final;
+        bool get(const solver_state_t& state0, solver_state_t& state) final;
+        bool prepare(const solver_state_t& state0) final;
+
+    private:
+
+        // attributes
+        scalar_t        m_tolerance{1e-6};      ///< relative tolerance of the directional derivative
+        scalar_t        m_tau1{4};              ///< extrapolation factor
+        vector_t        m_coeffs;               ///< restriction of the function to the current line
+        bool            m_restricted{false};    ///< whether the restriction to the current line is available
+    };
+}
@@ -20,6 +20,11 @@ void lsearchk_lemarechal_t::config(const json_t& json)
     nano::from_json(json, "interpolation", m_interpolation);
 }
 
+rlsearchk_t lsearchk_lemarechal_t::clone() const
+{
+    return std::make_unique<lsearchk_lemarechal_t>(*this);
+}
+
 bool lsearchk_lemarechal_t::get(const solver_state_t& state0, solver_state_t& state)
 {
     lsearch_step_t L = state0;
@@ -60,7 +65,7 @@ bool lsearchk_lemarechal_t::get(const solver_state_t& state0, solver_state_t& st
 
         // next trial
         const auto next = lsearch_step_t::interpolate(L, R, m_interpolation);
-        const auto ok = state.update(state0, clamp(next, tmin, tmax));
+        const auto ok = trial(state0, state, clamp(next, tmin, tmax));
         log(state0, state);
 
         if (!ok)
@@ -152,6 +152,11 @@ void lsearchk_morethuente_t::config(const json_t&)
 {
 }
 
+rlsearchk_t lsearchk_morethuente_t::clone() const
+{
+    return std::make_unique<lsearchk_morethuente_t>(*this);
+}
+
 bool lsearchk_morethuente_t::get(const solver_state_t& state0, solver_state_t& state)
 {
     const auto ftol = c1();
@@ -247,7 +252,7 @@ bool lsearchk_morethuente_t::get(const solver_state_t& state0, solver_state_t& s
         }
 
         // Obtain another function and derivative
-        state.update(state0, stp);
+        trial(state0, state, stp);
         log(state0, state);
         f = state.f;
         g = state.dg();
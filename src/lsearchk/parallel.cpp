@@ -0,0 +1,148 @@
+#include "parallel.h"
+#include <nano/tpool.h>
+#include <nano/numeric.h>
+
+using namespace nano;
+
+json_t lsearchk_parallel_t::config() const
+{
+    json_t json;
+    json["trials"] = strcat(m_trials, "(2,16)");
+    json["interpolation"] = strcat(m_interpolation, join(enum_values<interpolation>()));
+    json["pool"] = m_pool;
+    return json;
+}
+
+void lsearchk_parallel_t::config(const json_t& json)
+{
+    nano::from_json_range(json, "trials", m_trials, 2, 16);
+    nano::from_json(json, "interpolation", m_interpolation);
+    nano::from_json(json, "pool", m_pool);
+}
+
+rlsearchk_t lsearchk_parallel_t::clone() const
+{
+    return std::make_unique<lsearchk_parallel_t>(*this);
+}
+
+bool lsearchk_parallel_t::prepare(const solver_state_t& state0)
+{
+    // NB: the buffers are allocated once to have no allocations while iterating
+    const auto trials = static_cast<size_t>(m_trials);
+    m_tvalues.resize(trials);
+    m_order.resize(trials);
+    m_states.resize(trials, state0);
+    for (auto& state : m_states)
+    {
+        state = state0;
+    }
+
+    // NB: the initial step length is evaluated together with the other candidates
+    return false;
+}
+
+bool lsearchk_parallel_t::get(const solver_state_t& state0, solver_state_t& state)
+{
+    const auto trials = m_tvalues.size();
+    auto& pool = tpool_t::instance(m_pool);
+
+    // initial candidates: t, t/2, t/4, ..., 2t
+    for (size_t k = 0; k + 1 < trials; ++ k)
+    {
+        m_tvalues[k] = state.t / static_cast<scalar_t>(size_t(1) << k);
+    }
+    m_tvalues[trials - 1] = 2 * state.t;
+
+    lsearch_step_t lo = state0, hi = state0, prev = state0;
+    for (int i = 0; i < max_iterations(); ++ i)
+    {
+        // evaluate the candidates at once
+        loopi(pool, trials, [&] (const size_t k, const size_t)
+        {
+            m_states[k].trial(state0, m_tvalues[k]);
+        });
+
+        for (size_t k = 0; k < trials; ++ k)
+        {
+            log(state0, m_states[k]);
+        }
+
+        // accept the first candidate (in the order of evaluation) satisfying the strong Wolfe conditions
+        for (size_t k = 0; k < trials; ++ k)
+        {
+            const auto& trial = m_states[k];
+            if (trial && trial.has_armijo(state0, c1()) && trial.has_strong_wolfe(state0, c2()))
+            {
+                state = trial;
+                return true;
+            }
+        }
+
+        // update the bracketing interval: lo decreases the function and hi not anymore
+        for (size_t k = 0; k < trials; ++ k)
+        {
+            m_order[k] = k;
+        }
+        std::sort(m_order.begin(), m_order.end(), [&] (const size_t k1, const size_t k2)
+        {
+            return m_tvalues[k1] < m_tvalues[k2];
+        });
+
+        bool bracketed = hi.t > lo.t;
+        for (const auto k : m_order)
+        {
+            const auto& trial = m_states[k];
+            if (trial.t <= lo.t || (bracketed && trial.t >= hi.t))
+            {
+                continue;
+            }
+
+            if (!trial || !trial.has_armijo(state0, c1()) || trial.dg() >= 0)
+            {
+                hi = trial;
+                bracketed = true;
+                break;
+            }
+            else
+            {
+                prev = lo;
+                lo = trial;
+            }
+        }
+
+        // next candidates
+        if (bracketed)
+        {
+            // interpolate within the bracketing interval and split it uniformly
+            const auto width = hi.t - lo.t;
+            if (width <= epsilon0<scalar_t>() * hi.t)
+            {
+                break;
+            }
+
+            const auto next = std::isfinite(hi.f) && std::isfinite(hi.g) ?
+                lsearch_step_t::interpolate(lo, hi, m_interpolation) : lsearch_step_t::bisection(lo, hi);
+
+            m_tvalues[0] = clamp(next, lo.t + width / 10, hi.t - width / 10);
+            for (size_t k = 1; k < trials; ++ k)
+            {
+                m_tvalues[k] = lo.t + width * static_cast<scalar_t>(k) / static_cast<scalar_t>(trials);
+            }
+        }
+        else
+        {
+            // extrapolate beyond the largest step length
+            const auto next = lsearch_step_t::cubic(prev, lo);
+
+            m_tvalues[0] = std::isfinite(next) ? clamp(next, 2 * lo.t, 4 * lo.t) : 2 * lo.t;
+            for (size_t k = 1; k < trials; ++ k)
+            {
+                m_tvalues[k] = std::min(lo.t * static_cast<scalar_t>(size_t(4) << k), stpmax());
+            }
+        }
+    }
+
+    // NB: not converged, so use the lowest function value
+    state = *std::min_element(m_states.begin(), m_states.end());
+    return false;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <nano/lsearch/lsearchk.h>
+
+namespace nano
+{
+    ///
+    /// \brief speculative line-search: several step lengths are evaluated at once using the thread pool
+    ///     (e.g. t, t/2, t/4 and 2t initially) and the first one satisfying the strong Wolfe conditions is accepted.
+    ///     Otherwise the next candidates are interpolated in the bracketing interval (see lsearch_step_t)
+    ///     or extrapolated beyond the largest step length if the function is still decreasing.
+    ///
+    /// NB: this trades more function evaluations for less wall-clock time per iteration,
+    ///     so it is useful for expensive functions when spare cores are available.
+    /// NB: the function must be thread-safe (e.g. the builtin functions and the linear models).
+    /// NB: the trials are evaluated using the single thread pool instance or the named one given by "pool"
+    ///     (e.g. to not share the threads with the multi-start optimization).
+    ///
+    class lsearchk_parallel_t final : public lsearchk_t
+    {
+    public:
+
+        lsearchk_parallel_t() = default;
+
+        json_t config() const final;
+        void config(const json_t&) final;
+        rlsearchk_t clone() const final;
+        bool get(const solver_state_t& state0, solver_state_t& state) final;
+        bool prepare(const solver_state_t& state0) final;
+
+    private:
+
+        // attributes
+        interpolation               m_interpolation{interpolation::cubic};  ///<
+        int                         m_trials{4};        ///< number of step lengths evaluated at once
+        std::vector<scalar_t>       m_tvalues;          ///< the step lengths evaluated at once
+        std::vector<size_t>         m_order;            ///< the step lengths sorted in increasing order
+        std::vector<solver_state_t> m_states;           ///< buffers for the trials evaluated at once
+        string_t                    m_pool;             ///< name of the thread pool (the single instance if empty)
+    };
+}
@@ -3,6 +3,11 @@
 #include "solver/cgd.h"
 #include "solver/lbfgs.h"
 #include "solver/quasi.h"
+#include "solver/lquasi.h"
+#include "solver/newton.h"
+#include "solver/trust.h"
+#include <nano/tpool.h>
+#include <nano/chrono.h>
 #include <nano/numeric.h>
 
 using namespace nano;
@@ -115,7 +120,7 @@ bool solver_t::done(const solver_function_t& function, solver_state_t& state, co
         log(state);
         return true;
     }
-    else if (!log(state))
+    else if (!log(state) || function.stopped())
     {
         // stopping was requested
         state.m_status = solver_state_t::status::stopped;
@@ -134,27 +139,88 @@ bool solver_t::log(solver_state_t& state) const
 }
 
 solver_state_t solver_t::minimize(const function_t& f, const vector_t& x0) const
+{
+    return minimize(f, x0, nullptr);
+}
+
+solver_state_t solver_t::minimize(const function_t& f, const vector_t& x0, const std::atomic<bool>* stop) const
 {
     assert(f.size() == x0.size());
 
-    // NB: create new line-search objects:
+    const auto timer = nano::timer_t{};
+
+    // NB: create new line-search objects by cloning the (configured, but never used) prototypes:
     //  - to have the solver thread-safe
     //  - to start with a fresh line-search history (needed for some strategies like CG_DESCENT)
-    auto lsearch0 = lsearch0_t::all().get(m_lsearch0_id);
+    auto lsearch0 = m_lsearch0->clone();
     lsearch0->epsilon(epsilon());
     lsearch0->logger(m_lsearch0_logger);
-    lsearch0->config(m_lsearch0->config());
 
-    auto lsearchk = lsearchk_t::all().get(m_lsearchk_id);
+    auto lsearchk = m_lsearchk->clone();
     lsearchk->c1(m_c1);
     lsearchk->c2(m_c2);
     lsearchk->logger(m_lsearchk_logger);
-    lsearchk->config(m_lsearchk->config());
 
     auto function = solver_function_t{f};
+    function.stop_flag(stop);
     auto lsearch = lsearch_t{std::move(lsearch0), std::move(lsearchk)};
 
-    return minimize(function, lsearch, x0);
+    auto state = minimize(function, lsearch, x0);
+    state.m_nanoseconds = timer.nanoseconds().count();
+    return state;
+}
+
+std::vector<solver_state_t> solver_t::minimize_multistart(const function_t& f, const std::vector<vector_t>& x0s,
+    const solver_multistart_t& policy) const
+{
+    return minimize_multistart(tpool_t::instance(), f, x0s, policy);
+}
+
+std::vector<solver_state_t> solver_t::minimize_multistart(tpool_t& pool, const function_t& f,
+    const std::vector<vector_t>& x0s, const solver_multistart_t& policy) const
+{
+    std::atomic<bool> stop{false};
+
+    std::vector<solver_state_t> states(x0s.size());
+    loopi(pool, x0s.size(), [&] (const size_t i, const size_t)
+    {
+        auto& state = states[i];
+        if (stop.load(std::memory_order_relaxed))
+        {
+            // NB: cancelled before starting, so don't waste any function evaluation!
+            state.x = x0s[i];
+            state.f = std::numeric_limits<scalar_t>::infinity();
+            state.m_status = solver_state_t::status::stopped;
+            return;
+        }
+
+        state = minimize(f, x0s[i], &stop);
+        if (state.m_status == solver_state_t::status::converged && state.f <= policy.m_target)
+        {
+            stop.store(true, std::memory_order_relaxed);
+        }
+    });
+
+    if (policy.m_result == solver_multistart::best && !states.empty())
+    {
+        auto best = std::min_element(states.begin(), states.end());
+        return {std::move(*best)};
+    }
+
+    return states;
+}
+
+std::vector<solver_state_t> solver_t::minimize_multistart(const function_t& f, const sampler_t& sampler,
+    const size_t trials, const solver_multistart_t& policy) const
+{
+    // NB: the sampler is called sequentially as it may be stateful (e.g. a random number generator)
+    std::vector<vector_t> x0s(trials);
+    for (size_t trial = 0; trial < trials; ++ trial)
+    {
+        x0s[trial] = sampler(trial);
+    }
+
+    return minimize_multistart(f, x0s, policy);
 }
 
 solver_factory_t& solver_t::all()
@@ -177,11 +243,19 @@ solver_factory_t& solver_t::all()
         manager.add<solver_cgd_dyhs_t>("cgd-dyhs", "conjugate gradient descent (DYHS)");
         manager.add<solver_cgd_frpr_t>("cgd-prfr", "conjugate gradient descent (FRPR)");
         manager.add<solver_lbfgs_t>("lbfgs", "limited-memory BFGS");
+        manager.add<solver_lsr1_t>("lsr1", "limited-memory SR1");
+        manager.add<solver_ldfp_t>("ldfp", "limited-memory DFP");
+        manager.add<solver_lhoshino_t>("lhoshino", "limited-memory quasi-newton method (Hoshino formula)");
+        manager.add<solver_lfletcher_t>("lfletcher", "limited-memory quasi-newton method (Fletcher's switch)");
         manager.add<solver_quasi_dfp_t>("dfp", "quasi-newton method (DFP)");
         manager.add<solver_quasi_sr1_t>("sr1", "quasi-newton method (SR1)");
         manager.add<solver_quasi_bfgs_t>("bfgs", "quasi-newton method (BFGS)");
+        manager.add<solver_quasi_bfgs_llt_t>("bfgs-llt", "quasi-newton method (BFGS with Cholesky factor updates)");
         manager.add<solver_quasi_hoshino_t>("hoshino", "quasi-newton method (Hoshino formula)");
         manager.add<solver_quasi_fletcher_t>("fletcher", "quasi-newton method (Fletcher's switch)");
+        manager.add<solver_newton_cg_t>("newton-cg", "truncated Newton method (Newton-CG)");
+        manager.add<solver_trust_cg_t>("trust-cg", "trust-region method (Steihaug-Toint conjugate gradient)");
+        manager.add<solver_trust_dogleg_t>("trust-dogleg", "trust-region method (dogleg with BFGS)");
     });
 
     return manager;
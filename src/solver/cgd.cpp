@@ -130,8 +130,8 @@ solver_state_t solver_cgd_t::minimize(const solver_function_t& function, const l
         }
 
         // line-search
-        pstate = cstate;
-        const auto iter_ok = lsearch.get(cstate);
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
         if (solver_t::done(function, cstate, iter_ok))
         {
             break;
@@ -22,6 +22,7 @@ solver_state_t solver_gd_t::minimize(const solver_function_t& function, const ls
     const vector_t& x0) const
 {
     auto cstate = solver_state_t{function, x0};
+    auto pstate = cstate;
     log(cstate);
 
     for (int i = 0; i < max_iterations(); ++ i)
@@ -30,7 +31,8 @@ solver_state_t solver_gd_t::minimize(const solver_function_t& function, const ls
         cstate.d = -cstate.g;
 
         // line-search
-        const auto iter_ok = lsearch.get(cstate);
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
         if (solver_t::done(function, cstate, iter_ok))
         {
             break;
@@ -0,0 +1,66 @@
+#include "history.h"
+
+using namespace nano;
+
+solver_history_t::solver_history_t(const tensor_size_t dims, const tensor_size_t capacity) :
+    m_SY(matrix_t::Zero(2 * capacity, dims)),
+    m_sy(matrix_t::Zero(capacity, capacity)),
+    m_yy(matrix_t::Zero(capacity, capacity)),
+    m_buffer(vector_t::Zero(2 * capacity))
+{
+    assert(dims > 0);
+    assert(capacity > 0);
+}
+
+void solver_history_t::clear()
+{
+    m_begin = 0;
+    m_size = 0;
+}
+
+void solver_history_t::update(const tensor_size_t k)
+{
+    const auto m = capacity();
+
+    // the new column: s_i.dot(y_k) and y_i.dot(y_k)
+    m_buffer.noalias() = m_SY * m_SY.row(m + k).transpose();
+    m_sy.col(k) = m_buffer.head(m);
+    m_yy.col(k) = m_buffer.tail(m);
+    m_yy.row(k) = m_yy.col(k).transpose();
+
+    // the new row: s_k.dot(y_j)
+    m_buffer.tail(m).noalias() = m_SY.bottomRows(m) * m_SY.row(k).transpose();
+    m_sy.row(k) = m_buffer.tail(m).transpose();
+}
+
+void solver_history_t::dots(const vector_t& v, vector_t& sv, vector_t& yv) const
+{
+    assert(sv.size() >= m_size);
+    assert(yv.size() >= m_size);
+
+    const auto m = capacity();
+
+    m_buffer.noalias() = m_SY * v;
+    for (tensor_size_t j = 0; j < m_size; ++ j)
+    {
+        sv(j) = m_buffer(slot(j));
+        yv(j) = m_buffer(m + slot(j));
+    }
+}
+
+void solver_history_t::axpy(const vector_t& a, const vector_t& b, vector_t& r) const
+{
+    assert(a.size() >= m_size);
+    assert(b.size() >= m_size);
+
+    const auto m = capacity();
+
+    // NB: the unused slots may store stale pairs, so their coefficients must be zero!
+    m_buffer.setZero();
+    for (tensor_size_t j = 0; j < m_size; ++ j)
+    {
+        m_buffer(slot(j)) = a(j);
+        m_buffer(m + slot(j)) = b(j);
+    }
+    r.noalias() += m_SY.transpose() * m_buffer;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <nano/tensor.h>
+
+namespace nano
+{
+    ///
+    /// \brief history of the most recent pairs (s = x_{k+1} - x_k, y = g_{k+1} - g_k)
+    ///     used by the limited-memory quasi-Newton methods.
+    ///
+    ///     the pairs are stored in a circular buffer as the rows of a single contiguous 2m x n matrix [S'; Y'],
+    ///     so that all inner products with a vector are computed with one matrix-vector product.
+    ///     the inner products s_i.dot(y_j) and y_i.dot(y_j) are updated incrementally with each new pair.
+    ///
+    ///     see "Representations of quasi-Newton matrices and their use in limited memory methods",
+    ///     by R. H. Byrd, J. Nocedal, R. B. Schnabel, 1994
+    ///
+    /// NB: the pairs are indexed in chronological order (0 - the oldest, size() - 1 - the most recent).
+    /// NB: all buffers are allocated at construction, so no allocation is performed while iterating.
+    ///
+    class solver_history_t
+    {
+    public:
+
+        ///
+        /// \brief constructor
+        ///
+        solver_history_t(const tensor_size_t dims, const tensor_size_t capacity);
+
+        ///
+        /// \brief remove all pairs
+        ///
+        void clear();
+
+        ///
+        /// \brief append a new pair by replacing the oldest one if the history is full
+        ///
+        template <typename tsvector, typename tyvector>
+        void push(const tsvector& s, const tyvector& y)
+        {
+            if (m_size < capacity())
+            {
+                ++ m_size;
+            }
+            else
+            {
+                m_begin = (m_begin + 1) % capacity();
+            }
+
+            const auto k = slot(m_size - 1);
+            m_SY.row(k) = s.transpose();
+            m_SY.row(capacity() + k) = y.transpose();
+            update(k);
+        }
+
+        ///
+        /// \brief compute the inner products with the given vector: sv_j = s_j.dot(v) and yv_j = y_j.dot(v)
+        ///
+        void dots(const vector_t& v, vector_t& sv, vector_t& yv) const;
+
+        ///
+        /// \brief accumulate the linear combination of the pairs: r += sum_j (a_j * s_j + b_j * y_j)
+        ///
+        void axpy(const vector_t& a, const vector_t& b, vector_t& r) const;
+
+        ///
+        /// \brief access functions
+        ///
+        auto size() const { return m_size; }
+        auto capacity() const { return m_sy.rows(); }
+        auto s(const tensor_size_t j) const { return m_SY.row(slot(j)).transpose(); }
+        auto y(const tensor_size_t j) const { return m_SY.row(capacity() + slot(j)).transpose(); }
+        auto sy(const tensor_size_t i, const tensor_size_t j) const { return m_sy(slot(i), slot(j)); }
+        auto yy(const tensor_size_t i, const tensor_size_t j) const { return m_yy(slot(i), slot(j)); }
+
+    private:
+
+        tensor_size_t slot(const tensor_size_t j) const
+        {
+            assert(j >= 0 && j < m_size);
+            return (m_begin + j) % capacity();
+        }
+
+        void update(const tensor_size_t k);
+
+        // attributes
+        matrix_t            m_SY;           ///< circular buffer of (s, y) pairs: [s_0'; ...; s_m-1'; y_0'; ...; y_m-1']
+        matrix_t            m_sy, m_yy;     ///< inner products s_i.dot(y_j), y_i.dot(y_j) indexed by buffer slot
+        mutable vector_t    m_buffer;       ///< buffer to compute matrix-vector products with [S'; Y']
+        tensor_size_t       m_begin{0};     ///< buffer slot of the oldest pair
+        tensor_size_t       m_size{0};      ///< number of pairs
+    };
+}
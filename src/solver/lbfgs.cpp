@@ -1,8 +1,117 @@
-#include <deque>
 #include "lbfgs.h"
+#include "history.h"
 
 using namespace nano;
 
+namespace
+{
+    ///
+    /// \brief buffers to compute the descent direction (allocated once to have no allocations while iterating).
+    ///
+    struct workspace_t
+    {
+        workspace_t(const tensor_size_t dims, const tensor_size_t history_size) :
+            q(dims),
+            p1(history_size), p2(history_size),
+            a(history_size), b(history_size),
+            R(history_size, history_size),
+            M(history_size, history_size)
+        {
+        }
+
+        // attributes
+        vector_t    q;                  ///<
+        vector_t    p1, p2;             ///< S' * g and Y' * g
+        vector_t    a, b;               ///< coefficients of the S and Y columns
+        matrix_t    R, M;               ///< upper triangular part of S' * Y and D + gamma * Y' * Y
+    };
+
+    ///
+    /// \brief r = H * g using the two-loop recursion,
+    ///     see "Numerical optimization", Nocedal & Wright, 2nd edition, p.178
+    ///
+    void two_loop(const solver_history_t& history, const vector_t& g, workspace_t& ws, vector_t& r)
+    {
+        const auto hsize = history.size();
+
+        auto& q = ws.q;
+        auto& alphas = ws.a;
+
+        q = g;
+        for (auto j = hsize - 1; j >= 0; -- j)
+        {
+            const auto alpha = history.s(j).dot(q) / history.sy(j, j);
+            q.noalias() -= alpha * history.y(j);
+            alphas(j) = alpha;
+        }
+
+        if (hsize == 0)
+        {
+            r = q;
+        }
+        else
+        {
+            r = history.sy(hsize - 1, hsize - 1) / history.yy(hsize - 1, hsize - 1) * q;
+        }
+
+        for (tensor_size_t j = 0; j < hsize; ++ j)
+        {
+            const auto beta = history.y(j).dot(r) / history.sy(j, j);
+            r.noalias() += history.s(j) * (alphas(j) - beta);
+        }
+    }
+
+    ///
+    /// \brief r = H * g using the compact representation (see (3.13) in Byrd et al., 1994):
+    ///     H = gamma * I + [S gamma*Y] * [R^-T * (D + gamma * Y'Y) * R^-1, -R^-T; -R^-1, 0] * [S'; gamma*Y'],
+    ///     so that the inner products with the history are computed with only two matrix-vector products.
+    ///
+    void compact(const solver_history_t& history, const vector_t& g, workspace_t& ws, vector_t& r)
+    {
+        const auto hsize = history.size();
+        if (hsize == 0)
+        {
+            r = g;
+            return;
+        }
+
+        const auto gamma = history.sy(hsize - 1, hsize - 1) / history.yy(hsize - 1, hsize - 1);
+
+        auto R = ws.R.topLeftCorner(hsize, hsize);
+        auto M = ws.M.topLeftCorner(hsize, hsize);
+        for (tensor_size_t i = 0; i < hsize; ++ i)
+        {
+            for (tensor_size_t j = 0; j < hsize; ++ j)
+            {
+                R(i, j) = (i <= j) ? history.sy(i, j) : scalar_t(0);
+                M(i, j) = gamma * history.yy(i, j) + ((i == j) ? history.sy(i, j) : scalar_t(0));
+            }
+        }
+
+        // p1 = S' * g, p2 = Y' * g
+        history.dots(g, ws.p1, ws.p2);
+
+        auto p1 = ws.p1.head(hsize);
+        auto p2 = ws.p2.head(hsize);
+        auto a = ws.a.head(hsize);
+        auto b = ws.b.head(hsize);
+
+        // b = R^-1 * p1
+        b = p1;
+        R.triangularView<Eigen::Upper>().solveInPlace(b);
+
+        // a = R^-T * (M * b - gamma * p2)
+        a.noalias() = M * b;
+        a -= gamma * p2;
+        R.transpose().triangularView<Eigen::Lower>().solveInPlace(a);
+
+        // r = gamma * g + S * a - gamma * Y * b
+        b *= -gamma;
+        r = gamma * g;
+        history.axpy(ws.a, ws.b, r);
+    }
+}
+
 solver_lbfgs_t::solver_lbfgs_t() :
     solver_t(1e-4, 9e-1)
 {
@@ -12,6 +121,7 @@ json_t solver_lbfgs_t::config() const
 {
     json_t json = solver_t::config();
     json["history"] = strcat(m_history_size, "(1,1000)");
+    json["representation"] = strcat(m_representation, join(enum_values<representation>()));
     return json;
 }
 
@@ -19,6 +129,7 @@ void solver_lbfgs_t::config(const json_t& json)
 {
     solver_t::config(json);
     nano::from_json_range(json, "history", m_history_size, 1, 1000);
+    nano::from_json(json, "representation", m_representation);
 }
 
 solver_state_t solver_lbfgs_t::minimize(const solver_function_t& function, const lsearch_t& lsearch,
@@ -28,48 +139,25 @@ solver_state_t solver_lbfgs_t::minimize(const solver_function_t& function, const
     auto pstate = cstate;
     log(cstate);
 
-    std::deque<vector_t> ss, ys;
-    vector_t q, r;
+    const auto history_size = static_cast<tensor_size_t>(m_history_size);
+
+    auto history = solver_history_t{function.size(), history_size};
+    auto workspace = workspace_t{function.size(), history_size};
+
+    vector_t r(function.size());
 
     for (int i = 0; i < max_iterations(); ++ i)
     {
         // descent direction
-        //      (see "Numerical optimization", Nocedal & Wright, 2nd edition, p.178)
-        q = cstate.g;
-
-        const auto hsize = ss.size();
-
-        std::vector<scalar_t> alphas(hsize);
-        for (size_t j = 0; j < hsize; ++ j)
+        switch (m_representation)
         {
-            const auto& s = ss[hsize - 1 - j];
-            const auto& y = ys[hsize - 1 - j];
-
-            const scalar_t alpha = s.dot(q) / s.dot(y);
-            q.noalias() -= alpha * y;
-            alphas[j] = alpha;
-        }
-
-        if (ss.empty())
-        {
-            r = q;
-        }
-        else
-        {
-            const auto& s = ss[hsize - 1];
-            const auto& y = ys[hsize - 1];
-
-            r = s.dot(y) / y.dot(y) * q;
-        }
-
-        for (size_t j = 0; j < hsize; ++ j)
-        {
-            const auto& s = ss[j];
-            const auto& y = ys[j];
+        case representation::compact:
+            compact(history, cstate.g, workspace, r);
+            break;
 
-            const scalar_t alpha = alphas[hsize - 1 - j];
-            const scalar_t beta = y.dot(r) / s.dot(y);
-            r.noalias() += s * (alpha - beta);
+        default:
+            two_loop(history, cstate.g, workspace, r);
+            break;
         }
 
         cstate.d = -r;
@@ -82,8 +170,8 @@ solver_state_t solver_lbfgs_t::minimize(const solver_function_t& function, const
         }
 
         // line-search
-        pstate = cstate;
-        const auto iter_ok = lsearch.get(cstate);
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
         if (solver_t::done(function, cstate, iter_ok))
         {
             break;
@@ -93,18 +181,11 @@ solver_state_t solver_lbfgs_t::minimize(const solver_function_t& function, const
         //      "A Multi-Batch L-BFGS Method for Machine Learning", page 6 - the non-convex case
         if (has_descent)
         {
-            ss.emplace_back(cstate.x - pstate.x);
-            ys.emplace_back(cstate.g - pstate.g);
-            if (ss.size() > m_history_size)
-            {
-                ss.pop_front();
-                ys.pop_front();
-            }
+            history.push(cstate.x - pstate.x, cstate.g - pstate.g);
         }
         else
         {
-            ss.clear();
-            ys.clear();
+            history.clear();
         }
     }
 
@@ -8,6 +8,8 @@ namespace nano
     /// \brief limited memory BGFS (l-BGFS).
     ///     see "Updating Quasi-Newton Matrices with Limited Storage",
     ///     by J. Nocedal, 1980
+    ///     see "Representations of quasi-Newton matrices and their use in limited memory methods",
+    ///     by R. H. Byrd, J. Nocedal, R. B. Schnabel, 1994
     ///     see "Numerical Optimization",
     ///     by J. Nocedal, S. Wright, 2006
     ///
@@ -15,6 +17,15 @@ namespace nano
     {
     public:
 
+        ///
+        /// \brief methods to compute the descent direction from the history of updates.
+        ///
+        enum class representation
+        {
+            two_loop,       ///< two-loop recursion - see (Nocedal, 1980)
+            compact,        ///< compact representation using matrix-vector products - see (Byrd et al., 1994)
+        };
+
         solver_lbfgs_t();
         json_t config() const final;
         void config(const json_t&) final;
@@ -24,5 +35,16 @@ namespace nano
 
         // attributes
         size_t          m_history_size{6};      ///< history size (number of previous gradients to use)
+        representation  m_representation{representation::two_loop};    ///<
     };
+
+    template <>
+    inline enum_map_t<solver_lbfgs_t::representation> enum_string<solver_lbfgs_t::representation>()
+    {
+        return
+        {
+            { solver_lbfgs_t::representation::two_loop,     "two-loop" },
+            { solver_lbfgs_t::representation::compact,      "compact" }
+        };
+    }
 }
@@ -0,0 +1,368 @@
+#include "lquasi.h"
+#include "history.h"
+#include <nano/numeric.h>
+
+using namespace nano;
+
+namespace
+{
+    ///
+    /// \brief solve in place the (small) linear system A * x = b using Gaussian elimination with partial pivoting,
+    ///     returns false if the system is (numerically) singular.
+    ///
+    /// NB: both the matrix and the right-hand side are overwritten (the solution is stored in b).
+    ///
+    template <typename tmatrix, typename tvector>
+    bool gauss(tmatrix&& A, tvector&& b)
+    {
+        const auto n = A.rows();
+        const auto eps = epsilon0<scalar_t>() * std::max(A.template lpNorm<Eigen::Infinity>(), scalar_t(1));
+
+        for (tensor_size_t k = 0; k < n; ++ k)
+        {
+            tensor_size_t pivot = k;
+            A.col(k).tail(n - k).cwiseAbs().maxCoeff(&pivot);
+            pivot += k;
+            if (!(std::fabs(A(pivot, k)) > eps))
+            {
+                return false;
+            }
+
+            A.row(k).swap(A.row(pivot));
+            std::swap(b(k), b(pivot));
+
+            for (tensor_size_t i = k + 1; i < n; ++ i)
+            {
+                const auto factor = A(i, k) / A(k, k);
+                A.row(i).tail(n - k) -= factor * A.row(k).tail(n - k);
+                b(i) -= factor * b(k);
+            }
+        }
+
+        for (tensor_size_t k = n - 1; k >= 0; -- k)
+        {
+            b(k) = (b(k) - A.row(k).tail(n - k - 1).dot(b.tail(n - k - 1))) / A(k, k);
+        }
+
+        return true;
+    }
+}
+
+solver_lquasi_t::solver_lquasi_t() :
+    solver_t(1e-4, 9e-1)
+{
+}
+
+json_t solver_lquasi_t::config() const
+{
+    json_t json = solver_t::config();
+    json["history"] = strcat(m_history_size, "(1,1000)");
+    return json;
+}
+
+void solver_lquasi_t::config(const json_t& json)
+{
+    solver_t::config(json);
+    nano::from_json_range(json, "history", m_history_size, 1, 1000);
+}
+
+bool solver_lquasi_t::accept(const solver_history_t&, const vector_t&, const vector_t&, workspace_t&) const
+{
+    return true;
+}
+
+solver_state_t solver_lquasi_t::minimize(const solver_function_t& function, const lsearch_t& lsearch,
+    const vector_t& x0) const
+{
+    auto cstate = solver_state_t{function, x0};
+    auto pstate = cstate;
+    log(cstate);
+
+    const auto history_size = static_cast<tensor_size_t>(m_history_size);
+
+    auto history = solver_history_t{function.size(), history_size};
+    auto workspace = workspace_t{function.size(), history_size};
+
+    vector_t r(function.size()), dx(function.size()), dg(function.size());
+
+    for (int i = 0; i < max_iterations(); ++ i)
+    {
+        // descent direction
+        auto has_descent = hprod(history, cstate.g, workspace, r);
+        if (has_descent)
+        {
+            cstate.d = -r;
+            has_descent = cstate.has_descent();
+        }
+
+        // restart:
+        //  - if not a descent direction (the approximation is not necessarily positive definite)
+        if (!has_descent)
+        {
+            cstate.d = -cstate.g;
+        }
+
+        // line-search
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
+        if (solver_t::done(function, cstate, iter_ok))
+        {
+            break;
+        }
+
+        if (!has_descent)
+        {
+            history.clear();
+        }
+
+        dx = cstate.x - pstate.x;
+        dg = cstate.g - pstate.g;
+        if (dx.dot(dg) > epsilon0<scalar_t>() * dx.norm() * dg.norm() && accept(history, dx, dg, workspace))
+        {
+            history.push(dx, dg);
+        }
+    }
+
+    return cstate;
+}
+
+json_t solver_lsr1_t::config() const
+{
+    json_t json = solver_lquasi_t::config();
+    json["r"] = strcat(m_r, "(0,1)");
+    return json;
+}
+
+void solver_lsr1_t::config(const json_t& json)
+{
+    const auto eps = epsilon0<scalar_t>();
+
+    solver_lquasi_t::config(json);
+    nano::from_json_range(json, "r", m_r, eps, 1 - eps);
+}
+
+bool solver_lsr1_t::hprod(const solver_history_t& history, const vector_t& g, workspace_t& ws, vector_t& r) const
+{
+    const auto h = history.size();
+    if (h == 0)
+    {
+        r = g;
+        return true;
+    }
+
+    // NB: the initial approximation is the identity (as for the full SR1 by default),
+    //  because scaling it with the most recent pair invalidates the checks performed when the older pairs were accepted.
+    const auto gamma = scalar_t(1);
+
+    // N = R + R' - D - gamma * Y'Y
+    auto N = ws.N.topLeftCorner(h, h);
+    for (tensor_size_t i = 0; i < h; ++ i)
+    {
+        for (tensor_size_t j = 0; j < h; ++ j)
+        {
+            N(i, j) = history.sy(std::min(i, j), std::max(i, j)) - gamma * history.yy(i, j);
+        }
+    }
+
+    // z = N^-1 * (S - gamma * Y)' * g
+    history.dots(g, ws.p1, ws.p2);
+
+    auto z = ws.z.head(h);
+    z = ws.p1.head(h) - gamma * ws.p2.head(h);
+    if (!::gauss(N, z))
+    {
+        return false;
+    }
+
+    // r = gamma * g + (S - gamma * Y) * z
+    ws.a.head(h) = z;
+    ws.b.head(h) = -gamma * z;
+    r = gamma * g;
+    history.axpy(ws.a, ws.b, r);
+    return true;
+}
+
+bool solver_lsr1_t::accept(const solver_history_t& history, const vector_t& s, const vector_t& y,
+    workspace_t& ws) const
+{
+    // skip the update if the denominator is too small (see "Numerical optimization", Nocedal & Wright, p.145):
+    //  |(s - H * y).dot(y)| >= r * ||s|| * ||s - H * y||
+    auto& u = ws.u;
+    if (!hprod(history, y, ws, u))
+    {
+        return false;
+    }
+    u = s - u;
+
+    return std::fabs(u.dot(y)) >= m_r * s.norm() * u.norm();
+}
+
+bool solver_ldfp_t::hprod(const solver_history_t& history, const vector_t& g, workspace_t& ws, vector_t& r) const
+{
+    const auto h = history.size();
+    if (h == 0)
+    {
+        r = g;
+        return true;
+    }
+
+    const auto gamma = history.sy(h - 1, h - 1) / history.yy(h - 1, h - 1);
+
+    // N = [gamma * Y'Y, L; L', -D]
+    auto N = ws.N.topLeftCorner(2 * h, 2 * h);
+    for (tensor_size_t i = 0; i < h; ++ i)
+    {
+        for (tensor_size_t j = 0; j < h; ++ j)
+        {
+            const auto lij = (i > j) ? history.sy(j, i) : scalar_t(0);
+            const auto lji = (j > i) ? history.sy(i, j) : scalar_t(0);
+
+            N(i, j) = gamma * history.yy(i, j);
+            N(i, h + j) = lij;
+            N(h + i, j) = lji;
+            N(h + i, h + j) = (i == j) ? -history.sy(i, i) : scalar_t(0);
+        }
+    }
+
+    // z = N^-1 * [gamma * Y'; S'] * g
+    history.dots(g, ws.p1, ws.p2);
+
+    auto z = ws.z.head(2 * h);
+    z.head(h) = gamma * ws.p2.head(h);
+    z.tail(h) = ws.p1.head(h);
+    if (!::gauss(N, z))
+    {
+        return false;
+    }
+
+    // r = gamma * g - [gamma * Y, S] * z
+    ws.a.head(h) = -z.tail(h);
+    ws.b.head(h) = -gamma * z.head(h);
+    r = gamma * g;
+    history.axpy(ws.a, ws.b, r);
+    return true;
+}
+
+solver_lquasi_broyden_t::solver_lquasi_broyden_t() :
+    solver_t(1e-4, 9e-1)
+{
+}
+
+json_t solver_lquasi_broyden_t::config() const
+{
+    json_t json = solver_t::config();
+    json["H0"] = strcat(m_initialization, join(enum_values<solver_quasi_t::initialization>()));
+    json["history"] = strcat(m_history_size, "(1,1000)");
+    return json;
+}
+
+void solver_lquasi_broyden_t::config(const json_t& json)
+{
+    solver_t::config(json);
+    nano::from_json(json, "H0", m_initialization);
+    nano::from_json_range(json, "history", m_history_size, 1, 1000);
+}
+
+solver_state_t solver_lquasi_broyden_t::minimize(const solver_function_t& function, const lsearch_t& lsearch,
+    const vector_t& x0) const
+{
+    auto cstate = solver_state_t{function, x0};
+    auto pstate = cstate;
+    log(cstate);
+
+    const auto history_size = static_cast<tensor_size_t>(m_history_size);
+
+    // the pairs (s_j, u_j = H_j * y_j) and the coefficients (a_j, b_j, c_j) of the rank-2 updates
+    auto history = solver_history_t{function.size(), history_size};
+    matrix_t coeffs = matrix_t::Zero(history_size, 3);
+
+    vector_t sv(history_size), uv(history_size), a(history_size), b(history_size);
+    vector_t dx(function.size()), dg(function.size()), Hy(function.size());
+
+    auto gamma = scalar_t(1);
+
+    // r = H * g
+    const auto hprod = [&] (const vector_t& g, vector_t& r)
+    {
+        history.dots(g, sv, uv);
+        for (tensor_size_t j = 0; j < history.size(); ++ j)
+        {
+            a(j) = coeffs(j, 0) * sv(j) + coeffs(j, 1) * uv(j);
+            b(j) = coeffs(j, 1) * sv(j) + coeffs(j, 2) * uv(j);
+        }
+
+        r = gamma * g;
+        history.axpy(a, b, r);
+    };
+
+    for (int i = 0; i < max_iterations(); ++ i)
+    {
+        // descent direction
+        hprod(cstate.g, cstate.d);
+        cstate.d = -cstate.d;
+
+        // restart:
+        //  - if not a descent direction
+        if (!cstate.has_descent())
+        {
+            cstate.d = -cstate.g;
+            history.clear();
+            gamma = 1;
+        }
+
+        // line-search
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
+        if (solver_t::done(function, cstate, iter_ok))
+        {
+            break;
+        }
+
+        dx = cstate.x - pstate.x;
+        dg = cstate.g - pstate.g;
+
+        // initialize the Hessian's inverse
+        if (i == 0 && m_initialization == solver_quasi_t::initialization::scaled)
+        {
+            gamma = dx.dot(dg) / dg.dot(dg);
+        }
+
+        // NB: skip the update if the curvature condition is not satisfied to keep H positive definite!
+        const auto sy = dx.dot(dg);
+        if (!(sy > 0))
+        {
+            continue;
+        }
+
+        // update approximation of the Hessian
+        hprod(dg, Hy);
+
+        solver_quasi_t::dots_t dots;
+        dots.sy = sy;
+        dots.yHy = dg.dot(Hy);
+        dots.ss = dx.dot(dx);
+        dots.sHy = dx.dot(Hy);
+        dots.HyHy = Hy.dot(Hy);
+
+        const auto rank2 = update(dots);
+        if (!std::isfinite(rank2.a) || !std::isfinite(rank2.b) || !std::isfinite(rank2.c) ||
+            (rank2.a == 0 && rank2.b == 0 && rank2.c == 0))
+        {
+            continue;
+        }
+
+        // NB: the oldest update is dropped when the history is full!
+        if (history.size() == history.capacity())
+        {
+            for (tensor_size_t j = 0; j + 1 < history_size; ++ j)
+            {
+                coeffs.row(j) = coeffs.row(j + 1);
+            }
+        }
+
+        history.push(dx, Hy);
+        coeffs.row(history.size() - 1) << rank2.a, rank2.b, rank2.c;
+    }
+
+    return cstate;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "quasi.h"
+
+namespace nano
+{
+    class solver_history_t;
+
+    ///
+    /// \brief limited-memory quasi-Newton methods using the compact representation of the Hessian's inverse,
+    ///     so that both the memory and the work per iteration are O(m * n) (using the L-BFGS history storage).
+    ///     see "Representations of quasi-Newton matrices and their use in limited memory methods",
+    ///     by R. H. Byrd, J. Nocedal, R. B. Schnabel, 1994
+    ///
+    class solver_lquasi_t : public solver_t
+    {
+    public:
+
+        ///
+        /// \brief buffers to compute the descent direction (allocated once to have no allocations while iterating).
+        ///
+        struct workspace_t
+        {
+            workspace_t(const tensor_size_t dims, const tensor_size_t history_size) :
+                u(dims),
+                p1(history_size), p2(history_size),
+                a(history_size), b(history_size),
+                z(2 * history_size),
+                N(2 * history_size, 2 * history_size)
+            {
+            }
+
+            // attributes
+            vector_t    u;                  ///< s - H * y (to check the SR1 update)
+            vector_t    p1, p2;             ///< S' * g and Y' * g
+            vector_t    a, b;               ///< coefficients of the S and Y columns
+            vector_t    z;                  ///< solution of the small linear system
+            matrix_t    N;                  ///< middle matrix of the compact representation
+        };
+
+        solver_lquasi_t();
+        json_t config() const override;
+        void config(const json_t&) override;
+        solver_state_t minimize(const solver_function_t&, const lsearch_t&, const vector_t& x0) const final;
+
+    private:
+
+        ///
+        /// \brief compute r = H * g, returns false if not possible (e.g. singular middle matrix)
+        ///
+        virtual bool hprod(const solver_history_t&, const vector_t& g, workspace_t&, vector_t& r) const = 0;
+
+        ///
+        /// \brief check if the given pair can be appended to the history
+        ///
+        virtual bool accept(const solver_history_t&, const vector_t& s, const vector_t& y, workspace_t&) const;
+
+        // attributes
+        size_t          m_history_size{6};      ///< history size (number of previous gradients to use)
+    };
+
+    ///
+    /// \brief limited-memory Symmetric Rank One (L-SR1):
+    ///     H = I + (S - Y) * (R + R' - D - Y'Y)^-1 * (S - Y)',
+    ///     where R is the upper triangular part of S'Y and D is its diagonal.
+    ///
+    class solver_lsr1_t final : public solver_lquasi_t
+    {
+    public:
+
+        json_t config() const final;
+        void config(const json_t&) final;
+
+    private:
+
+        bool hprod(const solver_history_t&, const vector_t& g, workspace_t&, vector_t& r) const final;
+        bool accept(const solver_history_t&, const vector_t& s, const vector_t& y, workspace_t&) const final;
+
+        // attributes
+        scalar_t        m_r{1e-8};      ///< threshold to skip updates when the denominator is too small
+    };
+
+    ///
+    /// \brief limited-memory Davidon-Fletcher-Powell (L-DFP), the dual of the compact BFGS representation:
+    ///     H = gamma * I - [gamma * Y, S] * [gamma * Y'Y, L; L', -D]^-1 * [gamma * Y'; S'],
+    ///     where L is the strictly lower triangular part of Y'S, D is its diagonal and gamma = s'y / y'y (most recent pair).
+    ///
+    class solver_ldfp_t final : public solver_lquasi_t
+    {
+    private:
+
+        bool hprod(const solver_history_t&, const vector_t& g, workspace_t&, vector_t& r) const final;
+    };
+
+    ///
+    /// \brief limited-memory variants of the Broyden family (e.g. Hoshino, Fletcher's switch):
+    ///     the Hessian's inverse is stored as the most recent m rank-2 updates applied to H0 = gamma * I:
+    ///         H = gamma * I + sum_j (a_j * s_j * s_j' + b_j * (s_j * u_j' + u_j * s_j') + c_j * u_j * u_j'),
+    ///     where u_j = H_j * y_j is computed with the approximation available when the pair (s_j, y_j) was added.
+    ///
+    ///     the pairs (s_j, u_j) are kept in the L-BFGS history storage,
+    ///     so that both the memory and the work per iteration are O(m * n).
+    ///
+    /// NB: the coefficients of each update are given by the same formulas as the full-memory variants
+    ///     (see solver_quasi_t), as they depend only on the inner products of s, y and H * y.
+    /// NB: the oldest update is dropped when the history is full, without recomputing the newer ones.
+    ///
+    class solver_lquasi_broyden_t : public solver_t
+    {
+    public:
+
+        solver_lquasi_broyden_t();
+        json_t config() const override;
+        void config(const json_t&) override;
+        solver_state_t minimize(const solver_function_t&, const lsearch_t&, const vector_t& x0) const final;
+
+    private:
+
+        virtual solver_quasi_t::rank2_t update(const solver_quasi_t::dots_t&) const = 0;
+
+        // attributes
+        solver_quasi_t::initialization  m_initialization{solver_quasi_t::initialization::identity};    ///<
+        size_t          m_history_size{6};      ///< history size (number of previous updates to use)
+    };
+
+    ///
+    /// \brief limited-memory Hoshino formula (see solver_quasi_hoshino_t).
+    ///
+    class solver_lhoshino_t final : public solver_lquasi_broyden_t
+    {
+    public:
+
+        solver_quasi_t::rank2_t update(const solver_quasi_t::dots_t&) const final;
+    };
+
+    ///
+    /// \brief limited-memory Fletcher switch (see solver_quasi_fletcher_t).
+    ///
+    class solver_lfletcher_t final : public solver_lquasi_broyden_t
+    {
+    public:
+
+        solver_quasi_t::rank2_t update(const solver_quasi_t::dots_t&) const final;
+    };
+}
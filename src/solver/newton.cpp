@@ -0,0 +1,99 @@
+#include "newton.h"
+#include <nano/numeric.h>
+
+using namespace nano;
+
+solver_newton_cg_t::solver_newton_cg_t() :
+    solver_t(1e-4, 9e-1)
+{
+}
+
+json_t solver_newton_cg_t::config() const
+{
+    json_t json = solver_t::config();
+    json["eta"] = strcat(m_eta, "(0,1)");
+    json["max_cg_iterations"] = strcat(m_max_cg_iterations, "(1,10000)");
+    return json;
+}
+
+void solver_newton_cg_t::config(const json_t& json)
+{
+    const auto eps = epsilon0<scalar_t>();
+
+    solver_t::config(json);
+    nano::from_json_range(json, "eta", m_eta, eps, 1 - eps);
+    nano::from_json_range(json, "max_cg_iterations", m_max_cg_iterations, 1, 10000);
+}
+
+solver_state_t solver_newton_cg_t::minimize(const solver_function_t& function, const lsearch_t& lsearch,
+    const vector_t& x0) const
+{
+    auto cstate = solver_state_t{function, x0};
+    auto pstate = cstate;
+    log(cstate);
+
+    // NB: buffers allocated once to have no allocations while iterating
+    vector_t z(function.size());        // approximate solution of the Newton system: H * z = -g
+    vector_t r(function.size());        // residual: H * z + g
+    vector_t p(function.size());        // conjugate direction
+    vector_t Hp(function.size());       // Hessian-vector product: H * p
+
+    for (int i = 0; i < max_iterations(); ++ i)
+    {
+        // descent direction: truncated conjugate gradient iterations
+        const auto gnorm = cstate.g.lpNorm<2>();
+        const auto epsilon = std::min(m_eta, std::sqrt(gnorm)) * gnorm;
+
+        z.setZero();
+        r = cstate.g;
+        p = -r;
+
+        auto rr = r.dot(r);
+        for (int j = 0; j < m_max_cg_iterations; ++ j)
+        {
+            function.hvprod(cstate.x, p, Hp);
+
+            const auto pHp = p.dot(Hp);
+            if (!(pHp > 0))
+            {
+                // negative curvature: use the steepest descent direction if no progress was made so far
+                if (j == 0)
+                {
+                    z = -cstate.g;
+                }
+                break;
+            }
+
+            const auto alpha = rr / pHp;
+            z.noalias() += alpha * p;
+            r.noalias() += alpha * Hp;
+
+            const auto rr1 = r.dot(r);
+            if (std::sqrt(rr1) < epsilon)
+            {
+                break;
+            }
+
+            p = -r + (rr1 / rr) * p;
+            rr = rr1;
+        }
+
+        cstate.d = z;
+
+        // Force descent direction
+        if (!cstate.has_descent())
+        {
+            cstate.d = -cstate.g;
+        }
+
+        // line-search
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
+        if (solver_t::done(function, cstate, iter_ok))
+        {
+            break;
+        }
+    }
+
+    return cstate;
+}
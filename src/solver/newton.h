@@ -0,0 +1,29 @@
+#pragma once
+
+#include <nano/solver.h>
+
+namespace nano
+{
+    ///
+    /// \brief truncated Newton method (aka Newton-CG) with line-search.
+    ///     the Newton system is solved approximately with (matrix-free) conjugate gradient iterations
+    ///     using only Hessian-vector products and stopped at negative curvature directions.
+    ///     see "Numerical optimization", Nocedal & Wright, 2nd edition, p.168-169
+    ///     see "Truncated-Newton algorithms for large-scale unconstrained optimization", Dembo & Steihaug, 1983
+    ///
+    class solver_newton_cg_t final : public solver_t
+    {
+    public:
+
+        solver_newton_cg_t();
+        json_t config() const final;
+        void config(const json_t&) final;
+        solver_state_t minimize(const solver_function_t&, const lsearch_t&, const vector_t& x0) const final;
+
+    private:
+
+        // attributes
+        scalar_t        m_eta{0.5};                 ///< maximum forcing term: |r| <= min(eta, sqrt(|g|)) * |g|
+        int             m_max_cg_iterations{100};   ///< maximum number of conjugate gradient iterations
+    };
+}
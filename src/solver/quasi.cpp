@@ -1,72 +1,130 @@
 #include "quasi.h"
+#include "lquasi.h"
+#include <nano/tpool.h>
 #include <nano/numeric.h>
 
 using namespace nano;
 
 namespace
 {
-    template <typename tvector>
-    auto SR1(const matrix_t& H, const tvector& dx, const tvector& dg)
+    using dots_t = solver_quasi_t::dots_t;
+    using rank2_t = solver_quasi_t::rank2_t;
+
+    rank2_t SR1(const dots_t& dots)
     {
-        return  H + (dx - H * dg) * (dx - H * dg).transpose() / (dx - H * dg).dot(dg);
+        const auto denom = dots.sy - dots.yHy;
+        return {+1 / denom, -1 / denom, +1 / denom};
     }
 
-    template <typename tvector>
-    void SR1(matrix_t& H, const tvector& dx, const tvector& dg, const scalar_t r)
+    rank2_t SR1(const dots_t& dots, const scalar_t r)
     {
-        const auto denom = (dx - H * dg).dot(dg);
-        const auto apply = std::fabs(denom) >= r * dx.norm() * (dx - H * dg).norm();
+        // NB: ||s - Hy||^2 = s's - 2 * s'Hy + (Hy)'Hy
+        const auto denom = dots.sy - dots.yHy;
+        const auto unorm = std::sqrt(std::max(dots.ss - 2 * dots.sHy + dots.HyHy, scalar_t(0)));
+        const auto apply = std::fabs(denom) >= r * std::sqrt(dots.ss) * unorm;
 
-        if (apply)
-        {
-            H = SR1(H, dx, dg);
-        }
+        return apply ? SR1(dots) : rank2_t{};
     }
 
-    template <typename tvector>
-    auto DFP(const matrix_t& H, const tvector& dx, const tvector& dg)
+    rank2_t DFP(const dots_t& dots)
     {
-        return  H + (dx * dx.transpose()) / dx.dot(dg) -
-                (H * dg * dg.transpose() * H) / (dg.transpose() * H * dg);
+        return {+1 / dots.sy, 0, -1 / dots.yHy};
     }
 
-    template <typename tvector>
-    auto BFGS(const matrix_t& H, const tvector& dx, const tvector& dg)
+    rank2_t BFGS(const dots_t& dots)
     {
-        const auto I = matrix_t::Identity(H.rows(), H.cols());
+        const auto rho = 1 / dots.sy;
+        return {rho + rho * rho * dots.yHy, -rho, 0};
+    }
 
-        return  (I - dx * dg.transpose() / dx.dot(dg)) * H * (I - dg * dx.transpose() / dx.dot(dg)) +
-                dx * dx.transpose() / dx.dot(dg);
+    rank2_t combine(const scalar_t phi, const rank2_t& dfp, const rank2_t& bfgs)
+    {
+        return
+        {
+            (1 - phi) * dfp.a + phi * bfgs.a,
+            (1 - phi) * dfp.b + phi * bfgs.b,
+            (1 - phi) * dfp.c + phi * bfgs.c
+        };
     }
 
-    template <typename tvector>
-    auto HOSHINO(const matrix_t& H, const tvector& dx, const tvector& dg)
+    rank2_t HOSHINO(const dots_t& dots)
     {
-        const auto phi = dx.dot(dg) / (dx.dot(dg) + dg.transpose() * H * dg);
+        const auto phi = dots.sy / (dots.sy + dots.yHy);
 
-        return  (1 - phi) * DFP(H, dx, dg) + phi * BFGS(H, dx, dg);
+        return combine(phi, DFP(dots), BFGS(dots));
     }
 
-    template <typename tvector>
-    void FLETCHER(matrix_t& H, const tvector& dx, const tvector& dg)
+    rank2_t FLETCHER(const dots_t& dots)
     {
-        const auto phi = dx.dot(dg) / (dx.dot(dg) - dg.transpose() * H * dg);
+        const auto phi = dots.sy / (dots.sy - dots.yHy);
 
         if (phi < scalar_t(0))
         {
-            H = DFP(H, dx, dg);
+            return DFP(dots);
         }
         else if (phi > scalar_t(1))
         {
-            H = BFGS(H, dx, dg);
+            return BFGS(dots);
+        }
+        else
+        {
+            return SR1(dots);
+        }
+    }
+
+    ///
+    /// \brief apply the symmetric rank-2 update in place as two rank-1 updates:
+    ///     H += s * u' + Hy * v', where u = a * s + b * Hy and v = b * s + c * Hy.
+    ///
+    /// NB: the blocks of contiguous rows are updated independently (and in parallel if requested).
+    ///
+    void update(matrix_t& H, const vector_t& s, const vector_t& Hy, const rank2_t& rank2,
+        vector_t& u, vector_t& v, const bool parallel)
+    {
+        u = rank2.a * s + rank2.b * Hy;
+        v = rank2.b * s + rank2.c * Hy;
+
+        const auto op = [&] (const tensor_size_t begin, const tensor_size_t end, const tensor_size_t)
+        {
+            H.middleRows(begin, end - begin).noalias() += s.segment(begin, end - begin) * u.transpose();
+            H.middleRows(begin, end - begin).noalias() += Hy.segment(begin, end - begin) * v.transpose();
+        };
+
+        if (parallel)
+        {
+            loopr(H.rows(), tensor_size_t(64), op);
         }
         else
         {
-            H = SR1(H, dx, dg);
+            op(0, H.rows(), 0);
         }
     }
 }
 
+bool nano::cholupdate(matrix_t& R, vector_t& x, const scalar_t sign)
+{
+    const auto n = R.rows();
+    for (tensor_size_t k = 0; k < n; ++ k)
+    {
+        const auto r2 = R(k, k) * R(k, k) + sign * x(k) * x(k);
+        if (!std::isfinite(r2) || r2 <= 0)
+        {
+            return false;
+        }
+
+        const auto r = std::sqrt(r2);
+        const auto c = r / R(k, k);
+        const auto s = x(k) / R(k, k);
+        R(k, k) = r;
+
+        const auto m = n - k - 1;
+        R.row(k).tail(m) = (R.row(k).tail(m) + sign * s * x.tail(m).transpose()) / c;
+        x.tail(m) = c * x.tail(m) - s * R.row(k).tail(m).transpose();
+    }
+
+    return true;
+}
+
 solver_quasi_t::solver_quasi_t() :
     solver_t(1e-4, 9e-1)
 {
@@ -76,12 +134,14 @@ json_t solver_quasi_t::config() const
 {
     json_t json = solver_t::config();
     json["H0"] = strcat(m_initialization, join(enum_values<initialization>()));
+    json["parallel"] = strcat(m_parallel, "(0,1e+9)");
     return json;
 }
 
 void solver_quasi_t::config(const json_t& json)
 {
     nano::from_json(json, "H0", m_initialization);
+    nano::from_json_range(json, "parallel", m_parallel, 0, 1e+9);
     solver_t::config(json);
 }
 
@@ -95,10 +155,16 @@ solver_state_t solver_quasi_t::minimize(const solver_function_t& function, const
     // current approximation of the Hessian's inverse
     matrix_t H = matrix_t::Identity(function.size(), function.size());
 
+    // buffers to update the approximation of the Hessian's inverse in place
+    vector_t dx(function.size()), dg(function.size()), Hy(function.size());
+    vector_t u(function.size()), v(function.size());
+
+    const auto parallel = m_parallel > 0 && function.size() >= m_parallel;
+
     for (int i = 0; i < max_iterations(); ++ i)
     {
         // descent direction
-        cstate.d = -H * cstate.g;
+        cstate.d.noalias() = -H * cstate.g;
 
         // restart:
         //  - if not a descent direction
@@ -109,24 +175,24 @@ solver_state_t solver_quasi_t::minimize(const solver_function_t& function, const
         }
 
         // line-search
-        pstate = cstate;
-        const auto iter_ok = lsearch.get(cstate);
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
         if (solver_t::done(function, cstate, iter_ok))
         {
             break;
         }
 
+        dx = cstate.x - pstate.x;
+        dg = cstate.g - pstate.g;
+
         // initialize the Hessian's inverse
         if (i == 0)
         {
             switch (m_initialization)
             {
             case initialization::scaled:
-                {
-                    const auto dx = cstate.x - pstate.x;
-                    const auto dg = cstate.g - pstate.g;
-                    H = matrix_t::Identity(H.rows(), H.cols()) * dx.dot(dg) / dg.dot(dg);
-                }
+                H.setIdentity();
+                H *= dx.dot(dg) / dg.dot(dg);
                 break;
 
             default:
@@ -135,7 +201,16 @@ solver_state_t solver_quasi_t::minimize(const solver_function_t& function, const
         }
 
         // update approximation of the Hessian
-        update(pstate, cstate, H);
+        Hy.noalias() = H * dg;
+
+        dots_t dots;
+        dots.sy = dx.dot(dg);
+        dots.yHy = dg.dot(Hy);
+        dots.ss = dx.dot(dx);
+        dots.sHy = dx.dot(Hy);
+        dots.HyHy = Hy.dot(Hy);
+
+        ::update(H, dx, Hy, update(dots), u, v, parallel);
     }
 
     return cstate;
@@ -143,7 +218,7 @@ solver_state_t solver_quasi_t::minimize(const solver_function_t& function, const
 
 json_t solver_quasi_sr1_t::config() const
 {
-    json_t json = solver_t::config();
+    json_t json = solver_quasi_t::config();
     json["r"] = strcat(m_r, "(0,1)");
     return json;
 }
@@ -156,27 +231,101 @@ void solver_quasi_sr1_t::config(const json_t& json)
     nano::from_json_range(json, "r", m_r, eps, 1 - eps);
 }
 
-void solver_quasi_sr1_t::update(const solver_state_t& prev, const solver_state_t& curr, matrix_t& H) const
+solver_quasi_t::rank2_t solver_quasi_sr1_t::update(const dots_t& dots) const
+{
+    return ::SR1(dots, m_r);
+}
+
+solver_quasi_t::rank2_t solver_quasi_dfp_t::update(const dots_t& dots) const
+{
+    return ::DFP(dots);
+}
+
+solver_quasi_t::rank2_t solver_quasi_bfgs_t::update(const dots_t& dots) const
 {
-    ::SR1(H, curr.x - prev.x, curr.g - prev.g, m_r);
+    return ::BFGS(dots);
 }
 
-void solver_quasi_dfp_t::update(const solver_state_t& prev, const solver_state_t& curr, matrix_t& H) const
+solver_quasi_t::rank2_t solver_quasi_hoshino_t::update(const dots_t& dots) const
 {
-    H = ::DFP(H, curr.x - prev.x, curr.g - prev.g);
+    return ::HOSHINO(dots);
 }
 
-void solver_quasi_bfgs_t::update(const solver_state_t& prev, const solver_state_t& curr, matrix_t& H) const
+solver_quasi_t::rank2_t solver_quasi_fletcher_t::update(const dots_t& dots) const
 {
-    H = ::BFGS(H, curr.x - prev.x, curr.g - prev.g);
+    return ::FLETCHER(dots);
 }
 
-void solver_quasi_hoshino_t::update(const solver_state_t& prev, const solver_state_t& curr, matrix_t& H) const
+solver_quasi_t::rank2_t solver_lhoshino_t::update(const solver_quasi_t::dots_t& dots) const
 {
-    H = ::HOSHINO(H, curr.x - prev.x, curr.g - prev.g);
+    return ::HOSHINO(dots);
 }
 
-void solver_quasi_fletcher_t::update(const solver_state_t& prev, const solver_state_t& curr, matrix_t& H) const
+solver_quasi_t::rank2_t solver_lfletcher_t::update(const solver_quasi_t::dots_t& dots) const
 {
-    ::FLETCHER(H, curr.x - prev.x, curr.g - prev.g);
+    return ::FLETCHER(dots);
+}
+
+solver_quasi_bfgs_llt_t::solver_quasi_bfgs_llt_t() :
+    solver_t(1e-4, 9e-1)
+{
+}
+
+solver_state_t solver_quasi_bfgs_llt_t::minimize(const solver_function_t& function, const lsearch_t& lsearch,
+    const vector_t& x0) const
+{
+    auto cstate = solver_state_t{function, x0};
+    auto pstate = cstate;
+    log(cstate);
+
+    // upper triangular Cholesky factor of the current approximation of the Hessian: B = R' * R
+    matrix_t R = matrix_t::Identity(function.size(), function.size());
+
+    // buffers to update the Cholesky factor in place
+    vector_t dx(function.size()), dg(function.size()), Rs(function.size()), Bs(function.size());
+
+    for (int i = 0; i < max_iterations(); ++ i)
+    {
+        // descent direction: solve R' * R * d = -g
+        cstate.d = -cstate.g;
+        R.transpose().triangularView<Eigen::Lower>().solveInPlace(cstate.d);
+        R.triangularView<Eigen::Upper>().solveInPlace(cstate.d);
+
+        // restart:
+        //  - if not a descent direction (e.g. numerical issues)
+        if (!cstate.has_descent())
+        {
+            cstate.d = -cstate.g;
+            R.setIdentity();
+        }
+
+        // line-search
+        std::swap(pstate, cstate);
+        const auto iter_ok = lsearch.get(pstate, cstate);
+        if (solver_t::done(function, cstate, iter_ok))
+        {
+            break;
+        }
+
+        dx = cstate.x - pstate.x;
+        dg = cstate.g - pstate.g;
+
+        // update the Cholesky factor: B + y * y' / y's - B * s * s' * B / s'Bs
+        // NB: skip the update if the curvature condition is not satisfied to keep B positive definite!
+        const auto sy = dx.dot(dg);
+        if (sy > epsilon0<scalar_t>() * dx.norm() * dg.norm())
+        {
+            Rs.noalias() = R.triangularView<Eigen::Upper>() * dx;
+            Bs.noalias() = R.transpose().triangularView<Eigen::Lower>() * Rs;
+
+            dg /= std::sqrt(sy);
+            Bs /= std::sqrt(Rs.squaredNorm());
+            if (!cholupdate(R, dg, +1) || !cholupdate(R, Bs, -1))
+            {
+                R.setIdentity();
+            }
+        }
+    }
+
+    return cstate;
 }
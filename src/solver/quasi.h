@@ -24,6 +24,23 @@ namespace nano
             scaled,         ///< H0 = I * dg.dot(dx) / dg.dot(dg) - see (2)
         };
 
+        ///
+        /// \brief inner products of the update pair (s = dx, y = dg) and of Hy = H * y.
+        ///
+        struct dots_t
+        {
+            scalar_t    sy{0}, yHy{0}, ss{0}, sHy{0}, HyHy{0};  ///<
+        };
+
+        ///
+        /// \brief coefficients of the symmetric rank-2 update of the Hessian's inverse:
+        ///     H += a * s * s' + b * (s * Hy' + Hy * s') + c * Hy * Hy'
+        ///
+        struct rank2_t
+        {
+            scalar_t    a{0}, b{0}, c{0};                       ///<
+        };
+
         solver_quasi_t();
         json_t config() const override;
         void config(const json_t&) override;
@@ -31,10 +48,11 @@ namespace nano
 
     private:
 
-        virtual void update(const solver_state_t& prev, const solver_state_t& curr, matrix_t& H) const = 0;
+        virtual rank2_t update(const dots_t&) const = 0;
 
         // attributes
         initialization  m_initialization{initialization::identity}; ///<
+        tensor_size_t   m_parallel{0};          ///< update in parallel starting from this number of dimensions (0 - never)
     };
 
     ///
@@ -46,7 +64,7 @@ namespace nano
 
         json_t config() const final;
         void config(const json_t&) final;
-        void update(const solver_state_t&, const solver_state_t&, matrix_t&) const final;
+        rank2_t update(const dots_t&) const final;
 
     private:
 
@@ -61,7 +79,7 @@ namespace nano
     {
     public:
 
-        void update(const solver_state_t&, const solver_state_t&, matrix_t&) const final;
+        rank2_t update(const dots_t&) const final;
     };
 
     ///
@@ -71,7 +89,7 @@ namespace nano
     {
     public:
 
-        void update(const solver_state_t&, const solver_state_t&, matrix_t&) const final;
+        rank2_t update(const dots_t&) const final;
     };
 
     ///
@@ -81,7 +99,7 @@ namespace nano
     {
     public:
 
-        void update(const solver_state_t&, const solver_state_t&, matrix_t&) const final;
+        rank2_t update(const dots_t&) const final;
     };
 
     ///
@@ -91,9 +109,32 @@ namespace nano
     {
     public:
 
-        void update(const solver_state_t&, const solver_state_t&, matrix_t&) const final;
+        rank2_t update(const dots_t&) const final;
+    };
+
+    ///
+    /// \brief Broyden-Fletcher-Goldfarb-Shanno (BFGS) updating the Cholesky factor of the Hessian's approximation,
+    ///     so that both the update and the descent direction take O(n^2) and the approximation stays positive definite.
+    ///     see (1), section 3.4 and
+    ///     see "Numerical methods for unconstrained optimization and nonlinear equations", Dennis & Schnabel, 1983
+    ///
+    class solver_quasi_bfgs_llt_t final : public solver_t
+    {
+    public:
+
+        solver_quasi_bfgs_llt_t();
+        solver_state_t minimize(const solver_function_t&, const lsearch_t&, const vector_t& x0) const final;
     };
 
+    ///
+    /// \brief rank-1 update (sign > 0) or downdate (sign < 0) in place of the upper triangular Cholesky factor:
+    ///     R' * R + sign * x * x', returns false if the downdated matrix is not positive definite anymore.
+    ///
+    /// NB: the given vector is overwritten.
+    /// NB: the factor is processed by (contiguous) rows.
+    ///
+    bool cholupdate(matrix_t& R, vector_t& x, scalar_t sign);
+
     template <>
     inline enum_map_t<solver_quasi_t::initialization> enum_string<solver_quasi_t::initialization>()
     {
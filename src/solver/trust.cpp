@@ -0,0 +1,235 @@
+#include "trust.h"
+#include "quasi.h"
+#include <nano/numeric.h>
+
+using namespace nano;
+
+namespace
+{
+    ///
+    /// \brief return the positive step tau such that |z + tau * d| = radius (assuming |z| <= radius).
+    ///
+    scalar_t boundary(const vector_t& z, const vector_t& d, const scalar_t radius)
+    {
+        const auto a = d.dot(d);
+        const auto b = z.dot(d);
+        const auto c = z.dot(z) - radius * radius;
+
+        return (-b + std::sqrt(std::max(b * b - a * c, scalar_t(0)))) / a;
+    }
+}
+
+solver_trust_t::solver_trust_t() :
+    solver_t(1e-4, 9e-1)
+{
+}
+
+json_t solver_trust_t::config() const
+{
+    json_t json = solver_t::config();
+    json["eta"] = strcat(m_eta, "(0,0.25)");
+    json["delta0"] = strcat(m_delta0, "(0,inf)");
+    json["delta_max"] = strcat(m_delta_max, "(delta0,inf)");
+    return json;
+}
+
+void solver_trust_t::config(const json_t& json)
+{
+    const auto eps = epsilon0<scalar_t>();
+    const auto inf = 1 / eps;
+
+    solver_t::config(json);
+    nano::from_json_range(json, "eta", m_eta, eps, scalar_t(0.25) - eps);
+    nano::from_json_range(json, "delta0", m_delta0, eps, inf);
+    nano::from_json_range(json, "delta_max", m_delta_max, m_delta0, inf);
+}
+
+template <typename tstep, typename tupdate>
+solver_state_t solver_trust_t::minimize(const solver_function_t& function, const vector_t& x0,
+    const tstep& step, const tupdate& update) const
+{
+    auto cstate = solver_state_t{function, x0};
+    auto pstate = cstate;
+    log(cstate);
+
+    vector_t p(function.size());
+
+    auto delta = m_delta0;
+    for (int i = 0; i < max_iterations(); ++ i)
+    {
+        // trial step: (approximately) minimize the model within the trust region
+        const auto predicted = step(cstate, delta, p);
+
+        std::swap(pstate, cstate);
+        cstate.t = 1;
+        cstate.m_iterations = pstate.m_iterations;
+        cstate.update(pstate.x + p);
+
+        // adapt the trust region to how well the model predicted the actual decrease
+        //      see "Numerical optimization", Nocedal & Wright, 2nd edition, p.69
+        const auto pnorm = p.lpNorm<2>();
+        const auto rho = (pstate.f - cstate.f) / predicted;
+        if (!(rho >= scalar_t(0.25)))
+        {
+            delta = scalar_t(0.25) * pnorm;
+        }
+        else if (rho > scalar_t(0.75) && pnorm >= scalar_t(0.99) * delta)
+        {
+            delta = std::min(2 * delta, m_delta_max);
+        }
+
+        // accept the step or stay at the previous point
+        const auto accepted = predicted > 0 && rho > m_eta && static_cast<bool>(cstate);
+        if (accepted)
+        {
+            update(pstate, cstate);
+        }
+        else
+        {
+            std::swap(pstate, cstate);
+        }
+
+        // NB: the optimization fails if the trust region collapses
+        const auto iter_ok = delta > std::numeric_limits<scalar_t>::epsilon() * (1 + cstate.x.lpNorm<2>());
+        if (solver_t::done(function, cstate, iter_ok))
+        {
+            break;
+        }
+    }
+
+    return cstate;
+}
+
+json_t solver_trust_cg_t::config() const
+{
+    json_t json = solver_trust_t::config();
+    json["max_cg_iterations"] = strcat(m_max_cg_iterations, "(1,10000)");
+    return json;
+}
+
+void solver_trust_cg_t::config(const json_t& json)
+{
+    solver_trust_t::config(json);
+    nano::from_json_range(json, "max_cg_iterations", m_max_cg_iterations, 1, 10000);
+}
+
+solver_state_t solver_trust_cg_t::minimize(const solver_function_t& function, const lsearch_t&,
+    const vector_t& x0) const
+{
+    // NB: buffers allocated once to have no allocations while iterating
+    vector_t r(function.size());        // residual: H * z + g
+    vector_t d(function.size());        // conjugate direction
+    vector_t Hd(function.size());       // Hessian-vector product: H * d
+    vector_t Hp(function.size());       // Hessian-vector product: H * p
+
+    // Steihaug-Toint truncated conjugate gradient, see "Numerical optimization", Nocedal & Wright, 2nd edition, p.171
+    const auto step = [&] (const solver_state_t& state, const scalar_t delta, vector_t& p)
+    {
+        const auto gnorm = state.g.lpNorm<2>();
+        const auto epsilon = std::min(scalar_t(0.5), std::sqrt(gnorm)) * gnorm;
+
+        p.setZero();
+        Hp.setZero();
+        r = state.g;
+        d = -r;
+
+        auto rr = r.dot(r);
+        for (int j = 0; j < m_max_cg_iterations && std::sqrt(rr) >= epsilon; ++ j)
+        {
+            function.hvprod(state.x, d, Hd);
+
+            // stop at the boundary if negative curvature or if the step leaves the trust region
+            const auto dHd = d.dot(Hd);
+            const auto alpha = rr / dHd;
+            if (!(dHd > 0) || (p + alpha * d).lpNorm<2>() >= delta)
+            {
+                const auto tau = boundary(p, d, delta);
+                p.noalias() += tau * d;
+                Hp.noalias() += tau * Hd;
+                break;
+            }
+
+            p.noalias() += alpha * d;
+            Hp.noalias() += alpha * Hd;
+            r.noalias() += alpha * Hd;
+
+            const auto rr1 = r.dot(r);
+            d = -r + (rr1 / rr) * d;
+            rr = rr1;
+        }
+
+        return -(state.g.dot(p) + scalar_t(0.5) * p.dot(Hp));
+    };
+
+    const auto update = [] (const solver_state_t&, const solver_state_t&) {};
+
+    return solver_trust_t::minimize(function, x0, step, update);
+}
+
+solver_state_t solver_trust_dogleg_t::minimize(const solver_function_t& function, const lsearch_t&,
+    const vector_t& x0) const
+{
+    // upper triangular Cholesky factor of the current approximation of the Hessian: B = R' * R
+    matrix_t R = matrix_t::Identity(function.size(), function.size());
+
+    // NB: buffers allocated once to have no allocations while iterating
+    vector_t pB(function.size()), pU(function.size()), Rp(function.size());
+    vector_t dx(function.size()), dg(function.size()), Rs(function.size()), Bs(function.size());
+
+    // dogleg, see "Numerical optimization", Nocedal & Wright, 2nd edition, p.73
+    const auto step = [&] (const solver_state_t& state, const scalar_t delta, vector_t& p)
+    {
+        // full (quasi-)Newton step: solve R' * R * pB = -g
+        pB = -state.g;
+        R.transpose().triangularView<Eigen::Lower>().solveInPlace(pB);
+        R.triangularView<Eigen::Upper>().solveInPlace(pB);
+
+        if (pB.lpNorm<2>() <= delta)
+        {
+            p = pB;
+        }
+        else
+        {
+            // minimizer of the model along the steepest descent direction
+            Rp.noalias() = R.triangularView<Eigen::Upper>() * state.g;
+            pU = -state.g.dot(state.g) / Rp.squaredNorm() * state.g;
+
+            if (pU.lpNorm<2>() >= delta)
+            {
+                p = -delta / state.g.lpNorm<2>() * state.g;
+            }
+            else
+            {
+                pB -= pU;
+                p = pU + boundary(pU, pB, delta) * pB;
+            }
+        }
+
+        Rp.noalias() = R.triangularView<Eigen::Upper>() * p;
+        return -(state.g.dot(p) + scalar_t(0.5) * Rp.squaredNorm());
+    };
+
+    const auto update = [&] (const solver_state_t& pstate, const solver_state_t& cstate)
+    {
+        dx = cstate.x - pstate.x;
+        dg = cstate.g - pstate.g;
+
+        // update the Cholesky factor: B + y * y' / y's - B * s * s' * B / s'Bs
+        // NB: skip the update if the curvature condition is not satisfied to keep B positive definite!
+        const auto sy = dx.dot(dg);
+        if (sy > epsilon0<scalar_t>() * dx.norm() * dg.norm())
+        {
+            Rs.noalias() = R.triangularView<Eigen::Upper>() * dx;
+            Bs.noalias() = R.transpose().triangularView<Eigen::Lower>() * Rs;
+
+            dg /= std::sqrt(sy);
+            Bs /= std::sqrt(Rs.squaredNorm());
+            if (!cholupdate(R, dg, +1) || !cholupdate(R, Bs, -1))
+            {
+                R.setIdentity();
+            }
+        }
+    };
+
+    return solver_trust_t::minimize(function, x0, step, update);
+}
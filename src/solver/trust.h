@@ -0,0 +1,71 @@
+#pragma once
+
+#include <nano/solver.h>
+
+namespace nano
+{
+    ///
+    /// \brief trust-region methods: the step minimizes (approximately) a quadratic model of the function
+    ///     within a ball of given radius, that is adapted to how well the model predicts the actual decrease.
+    ///     see "Numerical optimization", Nocedal & Wright, 2nd edition, chapters 4 and 7
+    ///     see "Trust-region methods", Conn, Gould & Toint, 2000
+    ///
+    /// NB: the line-search is not used.
+    ///
+    class solver_trust_t : public solver_t
+    {
+    public:
+
+        solver_trust_t();
+        json_t config() const override;
+        void config(const json_t&) override;
+        bool has_lsearch() const final { return false; }
+
+    protected:
+
+        ///
+        /// \brief minimize the given function using the given subproblem solver:
+        ///     step(state, radius, p) computes the step p with |p| <= radius and returns the model decrease and
+        ///     update(state0, state) updates the model (if needed) after an accepted step.
+        ///
+        template <typename tstep, typename tupdate>
+        solver_state_t minimize(const solver_function_t&, const vector_t& x0, const tstep&, const tupdate&) const;
+
+    private:
+
+        // attributes
+        scalar_t        m_eta{0.1};         ///< accept the step if the actual decrease is at least this fraction of the predicted one
+        scalar_t        m_delta0{1};        ///< initial trust-region radius
+        scalar_t        m_delta_max{1e+3};  ///< maximum trust-region radius
+    };
+
+    ///
+    /// \brief trust-region method with the Steihaug-Toint truncated conjugate gradient subproblem solver
+    ///     using the (exact or approximated) Hessian-vector products of the function.
+    ///     see "The conjugate gradient method and trust regions in large scale optimization", Steihaug, 1983
+    ///
+    class solver_trust_cg_t final : public solver_trust_t
+    {
+    public:
+
+        json_t config() const final;
+        void config(const json_t&) final;
+        solver_state_t minimize(const solver_function_t&, const lsearch_t&, const vector_t& x0) const final;
+
+    private:
+
+        // attributes
+        int             m_max_cg_iterations{100};   ///< maximum number of conjugate gradient iterations
+    };
+
+    ///
+    /// \brief trust-region method with the dogleg subproblem solver
+    ///     using the dense BFGS approximation of the Hessian (updated as a Cholesky factor).
+    ///
+    class solver_trust_dogleg_t final : public solver_trust_t
+    {
+    public:
+
+        solver_state_t minimize(const solver_function_t&, const lsearch_t&, const vector_t& x0) const final;
+    };
+}
@@ -0,0 +1,122 @@
+#include <mutex>
+#include "stoch/sgd.h"
+#include "stoch/adam.h"
+#include "stoch/svrg.h"
+#include "stoch/saga.h"
+#include <nano/numeric.h>
+
+using namespace nano;
+
+scalar_t stoch_function_t::vgrad_i(const vector_t& x, const tensor_size_t i, vector_t* gx) const
+{
+    return vgrad(x, i, i + 1, gx);
+}
+
+tensor_size_t stoch_function_t::ssize() const
+{
+    return size();
+}
+
+scalar_t stoch_function_t::sgrad_i(const vector_t& x, const tensor_size_t i, vector_t& s) const
+{
+    return vgrad_i(x, i, &s);
+}
+
+void stoch_function_t::expand_i(const tensor_size_t, const vector_t& s, const scalar_t alpha, vector_t& g) const
+{
+    g.noalias() += alpha * s;
+}
+
+void stoch_function_t::rgrad(const vector_t&, vector_t&) const
+{
+}
+
+json_t stoch_solver_t::config() const
+{
+    json_t json;
+    json["lrate"] = strcat(m_lrate, "(0,1e+3)");
+    json["decay"] = strcat(m_decay, "[0,1e+3)");
+    json["epsilon"] = strcat(m_epsilon, "(1e-12,1e-4)");
+    json["max_epochs"] = strcat(m_max_epochs, "(1,1000000)");
+
+    return json;
+}
+
+void stoch_solver_t::config(const json_t& json)
+{
+    const auto eps = epsilon0<scalar_t>();
+
+    nano::from_json_range(json, "lrate", m_lrate, eps, 1e+3 - eps);
+    nano::from_json_range(json, "decay", m_decay, 0, 1e+3 - eps);
+    nano::from_json_range(json, "epsilon", m_epsilon, 1e-12 + eps, 1e-4 - eps);
+    nano::from_json_range(json, "max_epochs", m_max_epochs, 1, 1000 * 1000);
+}
+
+solver_state_t stoch_solver_t::minimize(stoch_function_t& function, const vector_t& x0) const
+{
+    assert(function.size() == x0.size());
+
+    auto state = solver_state_t{function, x0};
+    state.m_fcalls = state.m_gcalls = 1;
+    log(state);
+
+    minimize(function, state);
+    return state;
+}
+
+scalar_t stoch_solver_t::epoch_lrate(const int epoch) const
+{
+    return m_lrate / (1 + m_decay * epoch);
+}
+
+bool stoch_solver_t::done(solver_state_t& state, const vector_t& x, const size_t calls) const
+{
+    // evaluate the parameters on all samples
+    const auto step_ok = state.update(x);
+    state.m_fcalls += calls + 1;
+    state.m_gcalls += calls + 1;
+
+    const auto converged = state.converged(m_epsilon);
+    if (converged || !step_ok)
+    {
+        // either converged or diverged
+        state.m_status = converged ?
+            solver_state_t::status::converged :
+            solver_state_t::status::failed;
+        log(state);
+        return true;
+    }
+    else if (!log(state))
+    {
+        // stopping was requested
+        state.m_status = solver_state_t::status::stopped;
+        return true;
+    }
+
+    // OK, go on with the optimization
+    return false;
+}
+
+bool stoch_solver_t::log(solver_state_t& state) const
+{
+    const auto status = !m_logger ? true : m_logger(state);
+    state.m_iterations ++;
+    return status;
+}
+
+stoch_solver_factory_t& stoch_solver_t::all()
+{
+    static stoch_solver_factory_t manager;
+
+    static std::once_flag flag;
+    std::call_once(flag, [] ()
+    {
+        manager.add<stoch_sgd_t>("sgd", "stochastic gradient descent");
+        manager.add<stoch_momentum_t>("momentum", "stochastic gradient descent with (heavy-ball) momentum");
+        manager.add<stoch_adam_t>("adam", "adaptive moment estimation (Adam)");
+        manager.add<stoch_svrg_t>("svrg", "stochastic variance reduced gradient (SVRG)");
+        manager.add<stoch_saga_t>("saga", "stochastic average gradient (SAGA)");
+    });
+
+    return manager;
+}
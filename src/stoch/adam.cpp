@@ -0,0 +1,41 @@
+#include "adam.h"
+#include <nano/numeric.h>
+
+using namespace nano;
+
+stoch_adam_t::stoch_adam_t()
+{
+    lrate(1e-3);
+}
+
+json_t stoch_adam_t::config() const
+{
+    json_t json = stoch_minibatch_t::config();
+    json["beta1"] = strcat(m_beta1, "(0,1)");
+    json["beta2"] = strcat(m_beta2, "(0,1)");
+    json["delta"] = strcat(m_delta, "(0,1)");
+    return json;
+}
+
+void stoch_adam_t::config(const json_t& json)
+{
+    const auto eps = epsilon0<scalar_t>();
+
+    stoch_minibatch_t::config(json);
+    nano::from_json_range(json, "beta1", m_beta1, eps, 1 - eps);
+    nano::from_json_range(json, "beta2", m_beta2, eps, 1 - eps);
+    nano::from_json_range(json, "delta", m_delta, eps, 1 - eps);
+}
+
+void stoch_adam_t::update(vector_t& x, const vector_t& g, const scalar_t lrate, const tensor_size_t step,
+    vector_t& m, vector_t& v) const
+{
+    m = m_beta1 * m + (1 - m_beta1) * g;
+    v = m_beta2 * v + (1 - m_beta2) * g.array().square().matrix();
+
+    const auto k = static_cast<scalar_t>(step);
+    const auto correction1 = 1 - std::pow(m_beta1, k);
+    const auto correction2 = 1 - std::pow(m_beta2, k);
+
+    x.array() -= lrate / correction1 * m.array() / ((v.array() / correction2).sqrt() + m_delta);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "sgd.h"
+
+namespace nano
+{
+    ///
+    /// \brief adaptive moment estimation (Adam):
+    ///     m = beta1 * m + (1 - beta1) * g,
+    ///     v = beta2 * v + (1 - beta2) * g^2,
+    ///     x = x - lrate * m / (1 - beta1^k) / (sqrt(v / (1 - beta2^k)) + delta).
+    ///     see "Adam: A method for stochastic optimization", Kingma & Ba, 2015
+    ///
+    class stoch_adam_t final : public stoch_minibatch_t
+    {
+    public:
+
+        stoch_adam_t();
+        json_t config() const final;
+        void config(const json_t&) final;
+
+    protected:
+
+        void update(vector_t& x, const vector_t& g, scalar_t lrate, tensor_size_t step,
+            vector_t& m, vector_t& v) const final;
+
+    private:
+
+        // attributes
+        scalar_t        m_beta1{0.9};       ///< decay rate of the first order moment
+        scalar_t        m_beta2{0.999};     ///< decay rate of the second order moment
+        scalar_t        m_delta{1e-8};      ///< small constant for numerical stability
+    };
+}
@@ -0,0 +1,59 @@
+#include "saga.h"
+#include <nano/random.h>
+
+using namespace nano;
+
+void stoch_saga_t::minimize(stoch_function_t& function, solver_state_t& state) const
+{
+    const auto samples = function.samples();
+    const auto scale = scalar_t(1) / static_cast<scalar_t>(samples);
+
+    auto rng = make_rng();
+    auto udist = make_udist<tensor_size_t>(0, samples - 1);
+
+    // NB: buffers allocated once to have no allocations while iterating
+    vector_t x = state.x;
+    vector_t s(function.ssize());           // gradient state of the current sample
+    vector_t so(function.ssize());          // previous gradient state of the current sample
+    vector_t avg = vector_t::Zero(x.size());// average of the stored gradients
+    vector_t dir(x.size());                 // update direction
+    matrix_t table(samples, function.ssize());
+
+    // initialize the table of gradient states at the starting point
+    for (tensor_size_t i = 0; i < samples; ++ i)
+    {
+        function.sgrad_i(x, i, s);
+        function.expand_i(i, s, scale, avg);
+        table.row(i) = s.transpose();
+    }
+    state.m_fcalls += static_cast<size_t>(samples);
+    state.m_gcalls += static_cast<size_t>(samples);
+
+    for (int epoch = 0; epoch < max_epochs(); ++ epoch)
+    {
+        const auto lrate = epoch_lrate(epoch);
+        for (tensor_size_t k = 0; k < samples; ++ k)
+        {
+            const auto i = udist(rng);
+            function.sgrad_i(x, i, s);
+            so = table.row(i).transpose();
+
+            dir = avg;
+            function.rgrad(x, dir);
+            function.expand_i(i, s, +1, dir);
+            function.expand_i(i, so, -1, dir);
+
+            x.noalias() -= lrate * dir;
+
+            // update the table and its average
+            so = s - so;
+            function.expand_i(i, so, scale, avg);
+            table.row(i) = s.transpose();
+        }
+
+        if (stoch_solver_t::done(state, x, static_cast<size_t>(samples)))
+        {
+            break;
+        }
+    }
+}
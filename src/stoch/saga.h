@@ -0,0 +1,28 @@
+#pragma once
+
+#include <nano/stoch.h>
+
+namespace nano
+{
+    ///
+    /// \brief stochastic average gradient (SAGA):
+    ///     the parameters are updated using randomly chosen samples i and
+    ///     a table of the last gradient evaluated for each sample:
+    ///     x = x - lrate * (grad(f_i)(x) - table_i + 1/N * sum(table_j, j=1,N)).
+    ///     see "SAGA: A fast incremental gradient method with support for non-strongly convex composite objectives",
+    ///         Defazio, Bach & Lacoste-Julien, 2014
+    ///
+    /// NB: the table stores the compact per-sample gradient states (e.g. a scalar per sample for linear models),
+    ///     so the memory usage is O(N * ssize) and not O(N * size).
+    ///
+    class stoch_saga_t final : public stoch_solver_t
+    {
+    public:
+
+        stoch_saga_t() = default;
+
+    protected:
+
+        void minimize(stoch_function_t&, solver_state_t&) const final;
+    };
+}
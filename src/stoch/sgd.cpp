@@ -0,0 +1,74 @@
+#include "sgd.h"
+#include <nano/numeric.h>
+
+using namespace nano;
+
+json_t stoch_minibatch_t::config() const
+{
+    json_t json = stoch_solver_t::config();
+    json["batch"] = strcat(m_batch, "(1,1000000)");
+    return json;
+}
+
+void stoch_minibatch_t::config(const json_t& json)
+{
+    stoch_solver_t::config(json);
+    nano::from_json_range(json, "batch", m_batch, 1, 1000 * 1000);
+}
+
+void stoch_minibatch_t::minimize(stoch_function_t& function, solver_state_t& state) const
+{
+    // NB: buffers allocated once to have no allocations while iterating
+    vector_t x = state.x;
+    vector_t g(x.size());
+    vector_t m = vector_t::Zero(x.size());
+    vector_t v = vector_t::Zero(x.size());
+
+    tensor_size_t step = 0;
+    for (int epoch = 0; epoch < max_epochs(); ++ epoch)
+    {
+        function.shuffle();
+
+        size_t calls = 0;
+        const auto lrate = epoch_lrate(epoch);
+        for (tensor_size_t begin = 0, samples = function.samples(); begin < samples; begin += m_batch, ++ calls)
+        {
+            const auto end = std::min(begin + m_batch, samples);
+            function.vgrad(x, begin, end, &g);
+            update(x, g, lrate, ++ step, m, v);
+        }
+
+        if (stoch_solver_t::done(state, x, calls))
+        {
+            break;
+        }
+    }
+}
+
+void stoch_sgd_t::update(vector_t& x, const vector_t& g, const scalar_t lrate, const tensor_size_t,
+    vector_t&, vector_t&) const
+{
+    x.noalias() -= lrate * g;
+}
+
+json_t stoch_momentum_t::config() const
+{
+    json_t json = stoch_minibatch_t::config();
+    json["momentum"] = strcat(m_momentum, "(0,1)");
+    return json;
+}
+
+void stoch_momentum_t::config(const json_t& json)
+{
+    const auto eps = epsilon0<scalar_t>();
+
+    stoch_minibatch_t::config(json);
+    nano::from_json_range(json, "momentum", m_momentum, eps, 1 - eps);
+}
+
+void stoch_momentum_t::update(vector_t& x, const vector_t& g, const scalar_t lrate, const tensor_size_t,
+    vector_t& m, vector_t&) const
+{
+    m = m_momentum * m + g;
+    x.noalias() -= lrate * m;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <nano/stoch.h>
+
+namespace nano
+{
+    ///
+    /// \brief stochastic solver that updates the parameters using the gradients
+    ///     of the (contiguous) minibatches of samples shuffled at the beginning of each epoch.
+    ///
+    class stoch_minibatch_t : public stoch_solver_t
+    {
+    public:
+
+        json_t config() const override;
+        void config(const json_t&) override;
+
+        ///
+        /// \brief set/access the minibatch size
+        ///
+        void batch(const tensor_size_t batch) { m_batch = batch; }
+        auto batch() const { return m_batch; }
+
+    protected:
+
+        void minimize(stoch_function_t&, solver_state_t&) const final;
+
+        ///
+        /// \brief update the parameters x using the minibatch gradient g at the given (1-based) step:
+        ///     - lrate is the (decayed) learning rate and
+        ///     - m and v are buffers of the first and second order moments (initially zero).
+        ///
+        virtual void update(vector_t& x, const vector_t& g, scalar_t lrate, tensor_size_t step,
+            vector_t& m, vector_t& v) const = 0;
+
+    private:
+
+        // attributes
+        tensor_size_t   m_batch{32};        ///< minibatch size
+    };
+
+    ///
+    /// \brief stochastic gradient descent: x = x - lrate * g.
+    ///
+    class stoch_sgd_t final : public stoch_minibatch_t
+    {
+    public:
+
+        stoch_sgd_t() = default;
+
+    protected:
+
+        void update(vector_t& x, const vector_t& g, scalar_t lrate, tensor_size_t step,
+            vector_t& m, vector_t& v) const final;
+    };
+
+    ///
+    /// \brief stochastic gradient descent with (heavy-ball) momentum:
+    ///     m = momentum * m + g,
+    ///     x = x - lrate * m.
+    ///
+    class stoch_momentum_t final : public stoch_minibatch_t
+    {
+    public:
+
+        stoch_momentum_t() = default;
+        json_t config() const final;
+        void config(const json_t&) final;
+
+    protected:
+
+        void update(vector_t& x, const vector_t& g, scalar_t lrate, tensor_size_t step,
+            vector_t& m, vector_t& v) const final;
+
+    private:
+
+        // attributes
+        scalar_t        m_momentum{0.9};    ///< momentum factor
+    };
+}
@@ -0,0 +1,41 @@
+#include "svrg.h"
+#include <nano/random.h>
+
+using namespace nano;
+
+void stoch_svrg_t::minimize(stoch_function_t& function, solver_state_t& state) const
+{
+    const auto samples = function.samples();
+
+    auto rng = make_rng();
+    auto udist = make_udist<tensor_size_t>(0, samples - 1);
+
+    // NB: buffers allocated once to have no allocations while iterating
+    vector_t x = state.x;
+    vector_t xs = state.x;
+    vector_t mu = state.g;
+    vector_t gx(x.size());
+    vector_t gs(x.size());
+
+    for (int epoch = 0; epoch < max_epochs(); ++ epoch)
+    {
+        // snapshot: the state evaluated on all samples at the end of the previous epoch
+        xs = state.x;
+        mu = state.g;
+        x = xs;
+
+        const auto lrate = epoch_lrate(epoch);
+        for (tensor_size_t k = 0; k < samples; ++ k)
+        {
+            const auto i = udist(rng);
+            function.vgrad_i(x, i, &gx);
+            function.vgrad_i(xs, i, &gs);
+            x.noalias() -= lrate * (gx - gs + mu);
+        }
+
+        if (stoch_solver_t::done(state, x, 2 * static_cast<size_t>(samples)))
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <nano/stoch.h>
+
+namespace nano
+{
+    ///
+    /// \brief stochastic variance reduced gradient (SVRG):
+    ///     at the beginning of each epoch the full gradient mu is computed at a snapshot xs,
+    ///     and then the parameters are updated using randomly chosen samples i:
+    ///     x = x - lrate * (grad(f_i)(x) - grad(f_i)(xs) + mu).
+    ///     see "Accelerating stochastic gradient descent using predictive variance reduction", Johnson & Zhang, 2013
+    ///
+    /// NB: the snapshot is the point evaluated on all samples at the end of the previous epoch.
+    ///
+    class stoch_svrg_t final : public stoch_solver_t
+    {
+    public:
+
+        stoch_svrg_t() = default;
+
+    protected:
+
+        void minimize(stoch_function_t&, solver_state_t&) const final;
+    };
+}
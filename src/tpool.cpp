@@ -0,0 +1,254 @@
+#include <map>
+#include <mutex>
+#include <cstdlib>
+#include <fstream>
+#include <nano/tpool.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+using namespace nano;
+
+namespace
+{
+    struct instance_t
+    {
+        tpool_config_t              m_config;               ///< configuration set before the first use (if any)
+        bool                        m_configured{false};    ///<
+        bool                        m_used{false};          ///< the thread pool was already created
+        std::unique_ptr<tpool_t>    m_pool;                 ///< the named thread pool (if created)
+    };
+
+    struct instances_t
+    {
+        std::mutex                      m_mutex;            ///<
+        std::map<string_t, instance_t>  m_instances;        ///< the single instance is stored with an empty name
+    };
+
+    instances_t& the_instances()
+    {
+        static instances_t instances;
+        return instances;
+    }
+
+    tpool_config_t use(instance_t& instance)
+    {
+        instance.m_used = true;
+        return instance.m_configured ? instance.m_config : tpool_config_t::from_env();
+    }
+
+    void configure(instance_t& instance, const string_t& name, const tpool_config_t& config)
+    {
+        if (instance.m_used)
+        {
+            throw std::runtime_error(strcat(
+                "thread pool <", name, ">: the configuration must be set before its first use!"));
+        }
+
+        instance.m_config = config;
+        instance.m_configured = true;
+    }
+
+    std::vector<std::vector<size_t>> numa_nodes()
+    {
+        // NB: the CPUs of each NUMA node are listed in /sys/devices/system/node/node<N>/cpulist
+        std::vector<std::vector<size_t>> nodes;
+        for (size_t node = 0; ; ++ node)
+        {
+            std::ifstream stream(strcat("/sys/devices/system/node/node", node, "/cpulist"));
+
+            string_t cpulist;
+            if (!stream.is_open() || !std::getline(stream, cpulist))
+            {
+                break;
+            }
+
+            try
+            {
+                nodes.push_back(tpool_config_t::parse_cpus(cpulist));
+            }
+            catch (std::exception&)
+            {
+                break;
+            }
+        }
+
+        return nodes;
+    }
+}
+
+std::vector<size_t> tpool_config_t::parse_cpus(const string_t& str)
+{
+    const auto parse = [&] (const string_t& token)
+    {
+        size_t pos = 0;
+        const auto cpu = std::stoul(token, &pos);
+        if (pos != token.size())
+        {
+            throw std::invalid_argument(strcat("invalid CPU <", token, "> in the CPU list <", str, ">!"));
+        }
+        return static_cast<size_t>(cpu);
+    };
+
+    std::vector<size_t> cpus;
+    for (size_t begin = 0; begin < str.size(); )
+    {
+        auto end = str.find(',', begin);
+        end = (end == string_t::npos) ? str.size() : end;
+
+        const auto token = str.substr(begin, end - begin);
+        const auto dash = token.find('-');
+        if (dash == string_t::npos)
+        {
+            cpus.push_back(parse(token));
+        }
+        else
+        {
+            const auto first = parse(token.substr(0, dash));
+            const auto last = parse(token.substr(dash + 1));
+            if (first > last)
+            {
+                throw std::invalid_argument(strcat("invalid CPU range <", token, "> in the CPU list <", str, ">!"));
+            }
+            for (auto cpu = first; cpu <= last; ++ cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+
+        begin = end + 1;
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+tpool_config_t tpool_config_t::from_env()
+{
+    tpool_config_t config;
+
+    if (const auto* mode = std::getenv("NANO_TPOOL_MODE"))
+    {
+        config.m_mode = from_string<tpool_mode>(mode);
+    }
+    if (const auto* workers = std::getenv("NANO_TPOOL_WORKERS"))
+    {
+        config.m_workers = from_string<size_t>(workers);
+    }
+    if (const auto* cpus = std::getenv("NANO_TPOOL_CPUS"))
+    {
+        config.m_affinity = true;
+        config.m_cpus = parse_cpus(cpus);
+    }
+    if (const auto* spin = std::getenv("NANO_TPOOL_SPIN"))
+    {
+        config.m_spin = from_string<size_t>(spin);
+    }
+
+    return config;
+}
+
+std::vector<size_t> nano::tpool_available_cpus()
+{
+    std::vector<size_t> cpus;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for (size_t cpu = 0; cpu < CPU_SETSIZE; ++ cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+
+    if (cpus.empty())
+    {
+        for (size_t cpu = 0; cpu < tpool_t::size(); ++ cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+size_t nano::tpool_numa_node(const size_t cpu)
+{
+    static const auto nodes = numa_nodes();
+
+    for (size_t node = 0; node < nodes.size(); ++ node)
+    {
+        if (std::binary_search(nodes[node].begin(), nodes[node].end(), cpu))
+        {
+            return node;
+        }
+    }
+
+    return 0;
+}
+
+bool nano::tpool_pin_thread(std::thread& thread, const size_t cpu)
+{
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    NANO_UNUSED2(thread, cpu);
+    return false;
+#endif
+}
+
+void tpool_t::configure(const tpool_config_t& config)
+{
+    configure(string_t(), config);
+}
+
+void tpool_t::configure(const string_t& name, const tpool_config_t& config)
+{
+    auto& instances = the_instances();
+
+    const std::lock_guard<std::mutex> lock(instances.m_mutex);
+    ::configure(instances.m_instances[name], name, config);
+}
+
+tpool_config_t tpool_t::instance_config()
+{
+    auto& instances = the_instances();
+
+    const std::lock_guard<std::mutex> lock(instances.m_mutex);
+    return use(instances.m_instances[string_t()]);
+}
+
+tpool_t& tpool_t::instance(const string_t& name)
+{
+    if (name.empty())
+    {
+        return instance();
+    }
+
+    auto& instances = the_instances();
+
+    const std::lock_guard<std::mutex> lock(instances.m_mutex);
+    auto& instance = instances.m_instances[name];
+    if (!instance.m_pool)
+    {
+        instance.m_pool = std::make_unique<tpool_t>(use(instance));
+    }
+    return *instance.m_pool;
+}
@@ -4,6 +4,27 @@
 
 using namespace nano;
 
+class function_wrong_grad_t final : public function_t
+{
+public:
+
+    explicit function_wrong_grad_t(const tensor_size_t dims) :
+        function_t("Wrong", dims, convexity::yes)
+    {
+    }
+
+    scalar_t vgrad(const vector_t& x, vector_t* gx) const override
+    {
+        if (gx)
+        {
+            *gx = 2 * x;
+            (*gx)(size() - 1) += 1;
+        }
+
+        return x.squaredNorm();
+    }
+};
+
 UTEST_BEGIN_MODULE(test_functions)
 
 UTEST_CASE(evaluate)
@@ -29,4 +50,155 @@ UTEST_CASE(evaluate)
     }
 }
 
+UTEST_CASE(vgrad_batch)
+{
+    for (const auto& rfunction : get_functions(1, 16, std::regex(".+")))
+    {
+        const auto& function = *rfunction;
+        std::cout << function.name() << std::endl;
+
+        const auto dims = function.size();
+        for (const tensor_size_t points : {1, 3, 17})
+        {
+            const matrix_t X = matrix_t::Random(points, dims);
+
+            vector_t f(points), fg(points);
+            matrix_t G(points, dims);
+
+            function.vgrad_batch(map_matrix(X.data(), points, dims), map_vector(fg.data(), points),
+                map_matrix(G.data(), points, dims));
+            function.vgrad_batch(map_matrix(X.data(), points, dims), map_vector(f.data(), points),
+                matrix_map_t(nullptr, 0, 0));
+
+            vector_t gx(dims);
+            for (tensor_size_t i = 0; i < points; ++ i)
+            {
+                const vector_t x = X.row(i).transpose();
+                const auto fx = function.vgrad(x, &gx);
+
+                UTEST_CHECK_CLOSE(f(i), fx, epsilon1<scalar_t>());
+                UTEST_CHECK_CLOSE(fg(i), fx, epsilon1<scalar_t>());
+                UTEST_CHECK_EIGEN_CLOSE(G.row(i).transpose(), gx, epsilon1<scalar_t>());
+            }
+        }
+    }
+}
+
+UTEST_CASE(hvprod)
+{
+    for (const auto& rfunction : get_functions(1, 16, std::regex(".+")))
+    {
+        const auto& function = *rfunction;
+        std::cout << function.name() << std::endl;
+
+        const auto trials = size_t(10);
+        for (size_t t = 0; t < trials; ++ t)
+        {
+            const vector_t x = vector_t::Random(function.size());
+            const vector_t v = vector_t::Random(function.size());
+
+            // NB: compare with the finite-difference approximation
+            vector_t Hv, Hv_approx;
+            function.hvprod(x, v, Hv);
+            function.hvprod_approx(x, v, Hv_approx);
+
+            UTEST_CHECK_EIGEN_CLOSE(Hv, Hv_approx, epsilon3<scalar_t>());
+        }
+    }
+}
+
+UTEST_CASE(vdir)
+{
+    for (const auto& rfunction : get_functions(1, 16, std::regex(".+")))
+    {
+        const auto& function = *rfunction;
+        std::cout << function.name() << std::endl;
+
+        const auto trials = size_t(10);
+        for (size_t t = 0; t < trials; ++ t)
+        {
+            const vector_t x = vector_t::Random(function.size());
+            const vector_t d = vector_t::Random(function.size());
+
+            // NB: compare with the dot product of the gradient (if supported)
+            vector_t gx(function.size());
+            const auto fx = function.vgrad(x, &gx);
+
+            scalar_t fd = 0, dg = 0;
+            if (function.vdir(x, d, fd, dg))
+            {
+                UTEST_CHECK_CLOSE(fd, fx, epsilon1<scalar_t>());
+                UTEST_CHECK_CLOSE(dg, gx.dot(d), epsilon1<scalar_t>());
+            }
+        }
+    }
+
+    const auto function = function_wrong_grad_t{4};
+    scalar_t fx = 0, dg = 0;
+    UTEST_CHECK(!function.vdir(vector_t::Random(4), vector_t::Random(4), fx, dg));
+}
+
+UTEST_CASE(line_coeffs)
+{
+    for (const auto& rfunction : get_functions(1, 16, std::regex(".+")))
+    {
+        const auto& function = *rfunction;
+        std::cout << function.name() << std::endl;
+
+        const vector_t x = vector_t::Random(function.size());
+        const vector_t d = vector_t::Random(function.size());
+
+        vector_t coeffs;
+        if (!function.line_coeffs(x, d, coeffs))
+        {
+            continue;
+        }
+
+        // NB: compare with the function value and the gradient along the line
+        const auto f0 = function.vgrad(x);
+        for (const auto t : {0.0, 0.1, 0.5, 1.0, 2.0})
+        {
+            vector_t gt(function.size());
+            const auto ft = function.vgrad(x + t * d, &gt);
+
+            scalar_t dphi = 0;
+            const auto dphi0 = function.line_vgrad(coeffs, t, dphi);
+            UTEST_CHECK_CLOSE(f0 + dphi0, ft, epsilon1<scalar_t>());
+            UTEST_CHECK_CLOSE(dphi, gt.dot(d), epsilon1<scalar_t>());
+        }
+    }
+}
+
+UTEST_CASE(grad_accuracy_directions)
+{
+    for (const auto& rfunction : get_functions(1, 16, std::regex(".+")))
+    {
+        const auto& function = *rfunction;
+        std::cout << function.name() << std::endl;
+
+        const auto trials = size_t(10);
+        for (size_t t = 0; t < trials; ++ t)
+        {
+            const vector_t x0 = vector_t::Random(function.size());
+
+            UTEST_CHECK_LESS(function.grad_accuracy(x0, 8), 10 * epsilon2<scalar_t>());
+
+            // NB: the random directions are reproducible for a given seed
+            UTEST_CHECK_EQUAL(function.grad_accuracy(x0, 8, 7), function.grad_accuracy(x0, 8, 7));
+        }
+    }
+}
+
+UTEST_CASE(grad_accuracy_wrong)
+{
+    for (const tensor_size_t dims : {1, 7, 100})
+    {
+        const auto function = function_wrong_grad_t(dims);
+        const vector_t x0 = vector_t::Random(dims);
+
+        UTEST_CHECK_GREATER(function.grad_accuracy(x0), epsilon3<scalar_t>());
+        UTEST_CHECK_GREATER(function.grad_accuracy(x0, 8), epsilon3<scalar_t>());
+    }
+}
+
 UTEST_END_MODULE()
@@ -2,6 +2,7 @@
 #include <utest/utest.h>
 #include <nano/solver.h>
 #include <nano/numeric.h>
+#include <nano/random.h>
 
 using namespace nano;
 
@@ -24,6 +25,8 @@ enum class lsearch_type
     cgdescent_wolfe,
     cgdescent_approx_wolfe,
     cgdescent_wolfe_approx_wolfe,
+    exact,
+    parallel,
 };
 
 static void setup_logger(const rlsearchk_t& lsearch, std::stringstream& stream)
@@ -32,7 +35,7 @@ static void setup_logger(const rlsearchk_t& lsearch, std::stringstream& stream)
     lsearch->logger([&] (const solver_state_t& state0, const solver_state_t& state)
     {
         stream
-            << "\tt=" << state.t << ",f=" << state.f << ",g=" << state.convergence_criterion()
+            << "\tt=" << state.t << ",f=" << state.f << ",dg=" << state.dg()
             << ",armijo=" << state.has_armijo(state0, lsearch->c1())
             << ",wolfe=" << state.has_wolfe(state0, lsearch->c2())
             << ",swolfe=" << state.has_strong_wolfe(state0, lsearch->c2())
@@ -62,6 +65,12 @@ static void test(
     UTEST_CHECK(lsearch->get(state, t0));
     UTEST_CHECK(state);
 
+    // check the gradient is evaluated at the accepted step (the trials may evaluate only the directional derivative)
+    vector_t gx(function.size());
+    UTEST_CHECK(state.has_gradient());
+    UTEST_CHECK_CLOSE(function.vgrad(state.x, &gx), state.f, epsilon1<scalar_t>());
+    UTEST_CHECK_EIGEN_CLOSE(gx, state.g, epsilon1<scalar_t>());
+
     switch (type)
     {
     case lsearch_type::backtrack:
@@ -83,6 +92,16 @@ static void test(
         UTEST_CHECK(state.has_strong_wolfe(state0, lsearch->c2()));
         break;
 
+    case lsearch_type::exact:
+        UTEST_CHECK(state.has_armijo(state0, lsearch->c1()));
+        UTEST_CHECK(state.has_strong_wolfe(state0, lsearch->c2()));
+        break;
+
+    case lsearch_type::parallel:
+        UTEST_CHECK(state.has_armijo(state0, lsearch->c1()));
+        UTEST_CHECK(state.has_strong_wolfe(state0, lsearch->c2()));
+        break;
+
     case lsearch_type::cgdescent_wolfe:
         UTEST_CHECK(state.has_armijo(state0, lsearch->c1()));
         UTEST_CHECK(state.has_wolfe(state0, lsearch->c2()));
@@ -128,6 +147,56 @@ const auto functions = get_functions(1, 16, std::regex(".+"));
 
 UTEST_BEGIN_MODULE(test_lsearch)
 
+UTEST_CASE(clone)
+{
+    for (const auto& lsearch_id : lsearch0_t::all().ids())
+    {
+        const auto lsearch = lsearch0_t::all().get(lsearch_id);
+        UTEST_REQUIRE(lsearch);
+
+        const auto clone = lsearch->clone();
+        UTEST_REQUIRE(clone);
+        UTEST_CHECK_EQUAL(clone->config().dump(), lsearch->config().dump());
+    }
+
+    for (const auto& lsearch_id : lsearchk_t::all().ids())
+    {
+        const auto lsearch = get_lsearch(lsearch_id, 1e-1, 5e-1);
+        lsearch->max_iterations(20);
+
+        const auto clone = lsearch->clone();
+        UTEST_REQUIRE(clone);
+        UTEST_CHECK_EQUAL(clone->config().dump(), lsearch->config().dump());
+        UTEST_CHECK_EQUAL(clone->c1(), lsearch->c1());
+        UTEST_CHECK_EQUAL(clone->c2(), lsearch->c2());
+        UTEST_CHECK_EQUAL(clone->max_iterations(), lsearch->max_iterations());
+    }
+}
+
+UTEST_CASE(trial)
+{
+    for (const auto& function : functions)
+    {
+        const auto sfunction = solver_function_t{*function};
+
+        auto state0 = solver_state_t{sfunction, vector_t::Random(function->size())};
+        state0.d = -state0.g;
+
+        // NB: the trials evaluate the gradient only if the directional derivative is not supported
+        const auto gcalls = sfunction.gcalls();
+
+        auto state = state0;
+        UTEST_CHECK(state.trial(state0, 0.1));
+
+        auto expected = state0;
+        expected.update(state0, 0.1);
+
+        UTEST_CHECK_CLOSE(state.f, expected.f, epsilon1<scalar_t>());
+        UTEST_CHECK_CLOSE(state.dg(), expected.dg(), epsilon1<scalar_t>());
+        UTEST_CHECK_EQUAL(sfunction.gcalls(), gcalls + (state.has_gradient() ? 2U : 1U));
+    }
+}
+
 UTEST_CASE(backtrack)
 {
     const auto lsearch_id = "backtrack";
@@ -172,6 +241,156 @@ UTEST_CASE(fletcher)
     }
 }
 
+UTEST_CASE(exact)
+{
+    const auto lsearch_id = "exact";
+    const auto lsearch = get_lsearch(lsearch_id);
+
+    for (const auto& function : functions)
+    {
+        test(lsearch, lsearch_id, *function, lsearch_type::exact);
+    }
+}
+
+UTEST_CASE(exact_restricted)
+{
+    const auto lsearch = get_lsearch("exact");
+
+    vector_t coeffs;
+    for (const auto& function : functions)
+    {
+        const auto sfunction = solver_function_t{*function};
+
+        auto state0 = solver_state_t{sfunction, vector_t::Random(function->size())};
+        state0.d = -state0.g;
+        if (!function->line_coeffs(state0.x, state0.d, coeffs))
+        {
+            continue;
+        }
+
+        // NB: the line-search trials use only the restriction of the function to the line,
+        //  so that the function and its gradient are evaluated only at the accepted step
+        const auto fcalls = sfunction.fcalls();
+        const auto gcalls = sfunction.gcalls();
+
+        auto state = state0;
+        UTEST_CHECK(lsearch->get(state, 1e-1));
+        UTEST_CHECK_EQUAL(sfunction.fcalls(), fcalls + 1);
+        UTEST_CHECK_EQUAL(sfunction.gcalls(), gcalls + 2);
+
+        // NB: the step length minimizes the function along the descent direction
+        UTEST_CHECK_LESS(std::fabs(state.dg()), 1e-5 * std::fabs(state0.dg()) + epsilon1<scalar_t>());
+    }
+}
+
+UTEST_CASE(exact_max_iterations)
+{
+    const auto lsearch = get_lsearch("exact", 1e-1, 1e-9);
+
+    auto rng = rng_t{42};
+    for (const auto& function : functions)
+    {
+        vector_t x0(function->size());
+        urand(-1.0, +1.0, x0.data(), x0.data() + x0.size(), rng);
+
+        auto state0 = solver_state_t{*function, x0};
+        state0.d = -state0.g;
+
+        // NB: start from a step length satisfying the Armijo condition,
+        //  so that the zoom has always a valid fallback when running out of iterations
+        auto t0 = 1e-1;
+        while (function->vgrad(x0 = state0.x + t0 * state0.d) > state0.f + t0 * lsearch->c1() * state0.dg())
+        {
+            t0 *= 0.5;
+        }
+
+        for (const auto max_iterations : {1, 2, 3, 5})
+        {
+            lsearch->max_iterations(max_iterations);
+
+            auto state = state0;
+            UTEST_CHECK(lsearch->get(state, t0));
+            UTEST_CHECK(state.has_armijo(state0, lsearch->c1()));
+        }
+    }
+}
+
+UTEST_CASE(parallel)
+{
+    const auto lsearch_id = "parallel";
+    const auto lsearch = get_lsearch(lsearch_id);
+
+    for (const auto& function : functions)
+    {
+        test(lsearch, lsearch_id, *function, lsearch_type::parallel);
+    }
+}
+
+UTEST_CASE(parallel_named_pool)
+{
+    const auto lsearch_id = "parallel";
+    const auto lsearch = get_lsearch(lsearch_id);
+    UTEST_REQUIRE_NOTHROW(lsearch->config(to_json("pool", "test-lsearch-pool")));
+    UTEST_CHECK_EQUAL(lsearch->config()["pool"].get<string_t>(), "test-lsearch-pool");
+
+    for (const auto& function : functions)
+    {
+        test(lsearch, lsearch_id, *function, lsearch_type::parallel);
+    }
+}
+
+UTEST_CASE(parallel_first_candidate)
+{
+    const auto lsearch = get_lsearch("parallel", 1e-4, 1e-1);
+
+    for (const auto& function : functions)
+    {
+        auto state0 = solver_state_t{*function, vector_t::Random(function->size())};
+        state0.d = -state0.g;
+
+        // NB: the initial step length is accepted if valid, even if the other candidates are valid as well
+        for (const auto t0 : {1e-2, 1e-1, 1e+0})
+        {
+            auto state1 = state0;
+            state1.update(state0, t0);
+            const auto valid = state1.has_armijo(state0, lsearch->c1()) && state1.has_strong_wolfe(state0, lsearch->c2());
+
+            auto state = state0;
+            UTEST_CHECK(lsearch->get(state, t0));
+            if (valid)
+            {
+                UTEST_CHECK_EQUAL(state.t, t0);
+            }
+        }
+    }
+}
+
+UTEST_CASE(parallel_fcalls)
+{
+    const auto lsearch = get_lsearch("parallel");
+
+    size_t trials = 0;
+    lsearch->logger([&] (const solver_state_t&, const solver_state_t&) { ++ trials; });
+
+    for (const auto& function : functions)
+    {
+        const auto sfunction = solver_function_t{*function};
+
+        auto state0 = solver_state_t{sfunction, vector_t::Random(function->size())};
+        state0.d = -state0.g;
+
+        // NB: the trials evaluated concurrently are all counted (plus the gradient at the accepted step if needed)
+        trials = 0;
+        const auto fcalls = sfunction.fcalls();
+
+        auto state = state0;
+        UTEST_CHECK(lsearch->get(state, 1e-1));
+        UTEST_CHECK_EQUAL(trials % 4, 0U);
+        UTEST_CHECK_GREATER_EQUAL(sfunction.fcalls(), fcalls + trials);
+        UTEST_CHECK_LESS_EQUAL(sfunction.fcalls(), fcalls + trials + 1);
+    }
+}
+
 UTEST_CASE(cgdescent_wolfe)
 {
     const auto lsearch_id = "cgdescent";
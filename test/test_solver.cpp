@@ -1,11 +1,29 @@
 #include <iomanip>
 #include <utest/utest.h>
 #include <nano/solver.h>
+#include <nano/tpool.h>
 #include <nano/numeric.h>
 #include <nano/function/sphere.h>
+#include <nano/function/rosenbrock.h>
+#include <nano/function/styblinski_tang.h>
 
 using namespace nano;
 
+#if defined(__GLIBC__)
+
+// NB: count the heap allocations of the current thread (including the ones performed by Eigen) by interposing malloc.
+extern "C" void* __libc_malloc(size_t);
+
+static thread_local size_t n_mallocs = 0;
+
+extern "C" void* malloc(size_t size)
+{
+    ++ n_mallocs;
+    return __libc_malloc(size);
+}
+
+#endif
+
 static void setup_logger(const rsolver_t& solver, std::stringstream& stream, size_t& iterations)
 {
     // log the optimization steps
@@ -280,4 +298,335 @@ UTEST_CASE(quasi_with_initializations)
     }
 }
 
+UTEST_CASE(quasi_with_parallel_updates)
+{
+    for (const auto& function : convex_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        for (const auto& solver_id : {"sr1", "dfp", "bfgs", "hoshino", "fletcher"})
+        {
+            const auto solver = solver_t::all().get(solver_id);
+            UTEST_REQUIRE(solver);
+
+            UTEST_REQUIRE_NOTHROW(solver->config(to_json("parallel", 1)));
+            test(solver, solver_id, *function, vector_t::Random(function->size()));
+        }
+    }
+}
+
+UTEST_CASE(quasi_bfgs_llt_equals_bfgs)
+{
+    for (const auto& function : convex_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        const auto x0 = vector_t{vector_t::Random(function->size())};
+
+        // NB: the first iterations should follow the same trajectory as the descent directions are the same
+        const auto solver1 = solver_t::all().get("bfgs");
+        const auto solver2 = solver_t::all().get("bfgs-llt");
+        UTEST_REQUIRE(solver1);
+        UTEST_REQUIRE(solver2);
+
+        solver1->max_iterations(3);
+        solver2->max_iterations(3);
+
+        const auto state1 = solver1->minimize(*function, x0);
+        const auto state2 = solver2->minimize(*function, x0);
+
+        UTEST_CHECK_EIGEN_CLOSE(state1.x, state2.x, epsilon2<scalar_t>());
+        UTEST_CHECK_CLOSE(state1.f, state2.f, epsilon2<scalar_t>());
+    }
+}
+
+UTEST_CASE(lbfgs_with_representations)
+{
+    for (const auto& function : all_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        const auto solver = solver_t::all().get("lbfgs");
+        UTEST_REQUIRE(solver);
+
+        for (const auto history : {1, 6, 20})
+        {
+            UTEST_REQUIRE_NOTHROW(solver->config(to_json("history", history, "representation", "two-loop")));
+            test(solver, "lbfgs", *function, vector_t::Random(function->size()));
+
+            UTEST_REQUIRE_NOTHROW(solver->config(to_json("history", history, "representation", "compact")));
+            test(solver, "lbfgs", *function, vector_t::Random(function->size()));
+        }
+    }
+}
+
+UTEST_CASE(lbfgs_compact_equals_two_loop)
+{
+    for (const auto& function : convex_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        const auto x0 = vector_t{vector_t::Random(function->size())};
+
+        const auto solver = solver_t::all().get("lbfgs");
+        UTEST_REQUIRE(solver);
+
+        // NB: the first iterations should follow the same trajectory as the descent directions are the same
+        solver->max_iterations(3);
+
+        UTEST_REQUIRE_NOTHROW(solver->config(to_json("representation", "two-loop")));
+        const auto state1 = solver->minimize(*function, x0);
+
+        UTEST_REQUIRE_NOTHROW(solver->config(to_json("representation", "compact")));
+        const auto state2 = solver->minimize(*function, x0);
+
+        UTEST_CHECK_EIGEN_CLOSE(state1.x, state2.x, epsilon1<scalar_t>());
+        UTEST_CHECK_CLOSE(state1.f, state2.f, epsilon1<scalar_t>());
+    }
+}
+
+UTEST_CASE(lquasi_with_history_sizes)
+{
+    for (const auto& function : convex_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        for (const auto& solver_id : {"lsr1", "ldfp", "lhoshino", "lfletcher"})
+        {
+            const auto solver = solver_t::all().get(solver_id);
+            UTEST_REQUIRE(solver);
+
+            for (const auto history : {1, 6, 20})
+            {
+                UTEST_REQUIRE_NOTHROW(solver->config(to_json("history", history)));
+                test(solver, solver_id, *function, vector_t::Random(function->size()));
+            }
+        }
+    }
+}
+
+UTEST_CASE(hvprod_calls)
+{
+    const vector_t v = vector_t::Random(7);
+
+    // NB: the analytic Hessian-vector product costs as much as a gradient evaluation
+    {
+        const function_sphere_t function(7);
+        const auto sfunction = solver_function_t{function};
+
+        vector_t Hv;
+        sfunction.hvprod(vector_t::Random(7), v, Hv);
+        UTEST_CHECK_EQUAL(sfunction.fcalls(), 0U);
+        UTEST_CHECK_EQUAL(sfunction.gcalls(), 1U);
+    }
+
+    // NB: while the finite-difference approximation evaluates two gradients
+    {
+        const function_rosenbrock_t function(7);
+        const auto sfunction = solver_function_t{function};
+
+        vector_t Hv;
+        sfunction.hvprod(vector_t::Random(7), v, Hv);
+        UTEST_CHECK_EQUAL(sfunction.fcalls(), 2U);
+        UTEST_CHECK_EQUAL(sfunction.gcalls(), 2U);
+    }
+}
+
+UTEST_CASE(newton_cg_with_cg_iterations)
+{
+    for (const auto& function : convex_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        const auto solver = solver_t::all().get("newton-cg");
+        UTEST_REQUIRE(solver);
+
+        for (const auto max_cg_iterations : {1, 2, 10})
+        {
+            UTEST_REQUIRE_NOTHROW(solver->config(to_json("max_cg_iterations", max_cg_iterations)));
+            test(solver, "newton-cg", *function, vector_t::Random(function->size()));
+        }
+    }
+}
+
+UTEST_CASE(trust_region_with_radii)
+{
+    for (const auto& function : all_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        for (const auto& solver_id : {"trust-cg", "trust-dogleg"})
+        {
+            const auto solver = solver_t::all().get(solver_id);
+            UTEST_REQUIRE(solver);
+            UTEST_CHECK(!solver->has_lsearch());
+
+            for (const auto delta0 : {1e-1, 1e+0, 1e+1})
+            {
+                UTEST_REQUIRE_NOTHROW(solver->config(to_json("delta0", delta0)));
+                test(solver, solver_id, *function, vector_t::Random(function->size()));
+            }
+        }
+    }
+}
+
+UTEST_CASE(repeated_minimizations)
+{
+    for (const auto& function : all_functions)
+    {
+        UTEST_REQUIRE(function);
+
+        // NB: each minimization starts with a fresh line-search history
+        //  (the CG_DESCENT initialization keeps track of the previous iterations).
+        const auto solver = solver_t::all().get("cgd");
+        UTEST_REQUIRE(solver);
+        UTEST_REQUIRE_NOTHROW(solver->lsearch0(string_t("cgdescent")));
+        UTEST_REQUIRE_NOTHROW(solver->lsearchk(string_t("cgdescent")));
+
+        const vector_t x0 = vector_t::Random(function->size());
+        const auto state0 = solver->minimize(*function, x0);
+        for (auto trial = 0; trial < 3; ++ trial)
+        {
+            const auto state = solver->minimize(*function, x0);
+            UTEST_CHECK_EQUAL(state.f, state0.f);
+            UTEST_CHECK_EQUAL(state.m_status, state0.m_status);
+            UTEST_CHECK_EQUAL(state.m_fcalls, state0.m_fcalls);
+            UTEST_CHECK_EQUAL(state.m_iterations, state0.m_iterations);
+        }
+    }
+}
+
+UTEST_CASE(multistart_all)
+{
+    const function_sphere_t function(7);
+
+    std::vector<vector_t> x0s(8);
+    std::generate(x0s.begin(), x0s.end(), [&] () { return vector_t::Random(function.size()); });
+
+    const auto solver = solver_t::all().get("lbfgs");
+    UTEST_REQUIRE(solver);
+
+    const auto states = solver->minimize_multistart(function, x0s);
+    UTEST_REQUIRE_EQUAL(states.size(), x0s.size());
+    for (size_t i = 0; i < states.size(); ++ i)
+    {
+        UTEST_CHECK_EQUAL(states[i].m_status, solver_state_t::status::converged);
+        UTEST_CHECK_CLOSE(states[i].f, solver->minimize(function, x0s[i]).f, epsilon0<scalar_t>());
+        UTEST_CHECK_LESS(states[i].convergence_criterion(), solver->epsilon());
+        UTEST_CHECK_GREATER(states[i].m_nanoseconds, 0);
+    }
+}
+
+UTEST_CASE(multistart_best)
+{
+    const function_styblinski_tang_t function(4);
+
+    const auto solver = solver_t::all().get("lbfgs");
+    UTEST_REQUIRE(solver);
+
+    std::vector<vector_t> x0s(16);
+    std::generate(x0s.begin(), x0s.end(), [&] () { return vector_t{vector_t::Random(function.size()) * 5}; });
+
+    size_t trials = 0;
+    const auto sampler = [&] (const size_t trial)
+    {
+        UTEST_CHECK_EQUAL(trial, trials ++);
+        return x0s[trial];
+    };
+
+    auto policy = solver_multistart_t{};
+    const auto states = solver->minimize_multistart(function, sampler, 16, policy);
+    UTEST_CHECK_EQUAL(trials, 16U);
+    UTEST_REQUIRE_EQUAL(states.size(), 16U);
+
+    trials = 0;
+    policy.m_result = solver_multistart::best;
+    const auto best = solver->minimize_multistart(function, sampler, 16, policy);
+    UTEST_REQUIRE_EQUAL(best.size(), 1U);
+    UTEST_CHECK_EQUAL(best[0].m_status, solver_state_t::status::converged);
+    for (const auto& state : states)
+    {
+        UTEST_CHECK_LESS_EQUAL(best[0].f, state.f + epsilon1<scalar_t>());
+    }
+}
+
+UTEST_CASE(multistart_cancel)
+{
+    const function_sphere_t function(7);
+
+    std::vector<vector_t> x0s(64);
+    std::generate(x0s.begin(), x0s.end(), [&] () { return vector_t::Random(function.size()); });
+
+    const auto solver = solver_t::all().get("gd");
+    UTEST_REQUIRE(solver);
+
+    auto policy = solver_multistart_t{};
+    policy.m_target = std::numeric_limits<scalar_t>::max();
+
+    // NB: use a small thread pool, so that some runs are still pending when the target is reached
+    //  (independently of the number of available cores)
+    tpool_t pool(tpool_mode::work_stealing, 2);
+
+    const auto states = solver->minimize_multistart(pool, function, x0s, policy);
+    UTEST_REQUIRE_EQUAL(states.size(), x0s.size());
+
+    size_t converged = 0, stopped = 0;
+    for (const auto& state : states)
+    {
+        converged += (state.m_status == solver_state_t::status::converged) ? 1 : 0;
+        stopped += (state.m_status == solver_state_t::status::stopped) ? 1 : 0;
+    }
+    UTEST_CHECK_GREATER_EQUAL(converged, 1U);
+    UTEST_CHECK_GREATER_EQUAL(stopped, 1U);
+    UTEST_CHECK_EQUAL(converged + stopped, x0s.size());
+}
+
+#if defined(__GLIBC__)
+
+UTEST_CASE(no_allocations_while_iterating)
+{
+    const function_rosenbrock_t function(16);
+
+    std::vector<rsolver_t> solvers;
+    for (const auto& solver_id : solver_t::all().ids(std::regex("gd|cgd.*|lbfgs|lsr1|ldfp|lhoshino|lfletcher|sr1|dfp|bfgs.*|hoshino|fletcher|trust-dogleg")))
+    {
+        solvers.push_back(solver_t::all().get(solver_id));
+    }
+    solvers.push_back(solver_t::all().get("lbfgs"));
+    solvers.back()->config(to_json("representation", "compact"));
+
+    for (const auto& solver : solvers)
+    {
+        UTEST_REQUIRE(solver);
+
+        for (const auto& lsearch0_id : all_lsearch0_ids)
+        {
+            for (const auto& lsearchk_id : all_lsearchk_ids)
+            {
+                UTEST_REQUIRE_NOTHROW(solver->lsearch0(lsearch0_id));
+                UTEST_REQUIRE_NOTHROW(solver->lsearchk(lsearchk_id));
+
+                // NB: the first iterations may allocate the buffers of the solver and of the line-search
+                size_t mallocs2 = 0, mallocsK = 0;
+                solver->logger([&] (const solver_state_t& state)
+                {
+                    const auto mallocs = n_mallocs;
+                    mallocs2 = (state.m_iterations <= 2) ? mallocs : mallocs2;
+                    mallocsK = mallocs;
+                    return true;
+                });
+                solver->max_iterations(100);
+
+                const auto state = solver->minimize(function, vector_t::Random(function.size()));
+                solver->logger({});
+
+                UTEST_CHECK_GREATER(state.m_iterations, 2U);
+                UTEST_CHECK_EQUAL(mallocsK - mallocs2, 0U);
+            }
+        }
+    }
+}
+
+#endif
+
 UTEST_END_MODULE()
@@ -0,0 +1,270 @@
+#include <utest/utest.h>
+#include <nano/linear.h>
+#include <nano/numeric.h>
+
+using namespace nano;
+
+///
+/// \brief synthetic dataset with a noise-free affine relation between the inputs and the targets.
+///
+class synthetic_dataset_t final : public dataset_t
+{
+public:
+
+    synthetic_dataset_t(const tensor_size_t samples, const tensor_size_t isize, const tensor_size_t osize,
+        const bool classification) :
+        m_inputs(samples, isize, 1, 1),
+        m_targets(samples, osize, 1, 1),
+        m_classification(classification)
+    {
+    }
+
+    json_t config() const override { return json_t{}; }
+    void config(const json_t&) override {}
+
+    bool load() override
+    {
+        m_inputs.random(-1, +1);
+        m_inputs.vector()(0) = feature_t::placeholder_value();
+
+        const matrix_t W = matrix_t::Random(m_targets.size<1>(), m_inputs.size<1>());
+        const vector_t b = vector_t::Random(m_targets.size<1>());
+        for (tensor_size_t i = 0; i < m_inputs.size<0>(); ++ i)
+        {
+            const auto input = m_inputs.vector(i).unaryExpr([] (const scalar_t value)
+            {
+                return std::isfinite(value) ? value : scalar_t(0);
+            });
+            const vector_t output = W * input + b;
+            m_targets.vector(i) = m_classification ?
+                output.unaryExpr([] (const scalar_t value) { return value > 0 ? pos_target() : neg_target(); }) :
+                output;
+        }
+
+        m_indices = indices_t::LinSpaced(m_inputs.size<0>(), 0, m_inputs.size<0>());
+        return true;
+    }
+
+    size_t folds() const override { return 1; }
+    size_t ifeatures() const override { return static_cast<size_t>(m_inputs.size<1>()); }
+
+    feature_t ifeature(const size_t index) const override
+    {
+        return feature_t::make_scalar(strcat("input", index));
+    }
+
+    feature_t tfeature() const override
+    {
+        strings_t labels;
+        for (tensor_size_t i = 0; m_classification && i < m_targets.size<1>(); ++ i)
+        {
+            labels.push_back(strcat("label", i));
+        }
+        return labels.empty() ?
+            feature_t::make_scalar("target") :
+            feature_t::make_discrete("target", labels);
+    }
+
+    tensor4d_t inputs(const fold_t&) const override { return index(m_inputs); }
+    tensor4d_t targets(const fold_t&) const override { return index(m_targets); }
+
+    void shuffle(const fold_t&) override
+    {
+        std::shuffle(begin(m_indices), end(m_indices), make_rng());
+    }
+
+private:
+
+    tensor4d_t index(const tensor4d_t& data) const
+    {
+        tensor4d_t idata(data.dims());
+        for (tensor_size_t i = 0; i < m_indices.size(); ++ i)
+        {
+            idata.tensor(i) = data.tensor(m_indices(i));
+        }
+        return idata;
+    }
+
+    // attributes
+    tensor4d_t      m_inputs;           ///<
+    tensor4d_t      m_targets;          ///<
+    indices_t       m_indices;          ///< current order of the samples
+    bool            m_classification{false};    ///<
+};
+
+static const auto fold = fold_t{0, protocol::train};
+
+UTEST_BEGIN_MODULE(test_stoch)
+
+UTEST_CASE(linear_function)
+{
+    for (const auto& loss_id : {"squared", "cauchy", "m-logistic"})
+    {
+        const auto classification = string_t(loss_id) == "m-logistic";
+        const auto osize = classification ? 3 : 1;
+
+        auto dataset = synthetic_dataset_t{100, 5, osize, classification};
+        UTEST_REQUIRE(dataset.load());
+
+        const auto loss = loss_t::all().get(loss_id);
+        UTEST_REQUIRE(loss);
+
+        for (const auto lambda : {0.0, 0.1})
+        {
+            auto function = linear_function_t{dataset, fold, *loss, lambda};
+            UTEST_CHECK_EQUAL(function.size(), osize * (5 + 1));
+            UTEST_CHECK_EQUAL(function.samples(), 100);
+            UTEST_CHECK_EQUAL(function.isize(), 5);
+            UTEST_CHECK_EQUAL(function.osize(), osize);
+
+            const vector_t x = vector_t::Random(function.size());
+            UTEST_CHECK_LESS(function.grad_accuracy(x), 10 * epsilon2<scalar_t>());
+
+            // the minibatches sum up to the full batch
+            vector_t gx, gb;
+            const auto fx = function.vgrad(x, &gx);
+            UTEST_CHECK(std::isfinite(fx));
+
+            scalar_t fsum = 0;
+            vector_t gsum = vector_t::Zero(function.size());
+            for (tensor_size_t begin = 0; begin < function.samples(); begin += 20)
+            {
+                fsum += function.vgrad(x, begin, begin + 20, &gb);
+                gsum += gb;
+            }
+            UTEST_CHECK_CLOSE(fsum / 5, fx, epsilon1<scalar_t>());
+            UTEST_CHECK_EIGEN_CLOSE(gsum / 5, gx, epsilon1<scalar_t>());
+
+            // the per-sample gradients are consistent with the minibatch ones
+            vector_t gi, gs, si;
+            for (tensor_size_t i = 0; i < function.samples(); i += 7)
+            {
+                const auto fi = function.vgrad_i(x, i, &gi);
+                UTEST_CHECK_CLOSE(fi, function.vgrad(x, i, i + 1), epsilon1<scalar_t>());
+
+                gs = vector_t::Zero(function.size());
+                UTEST_CHECK_CLOSE(function.sgrad_i(x, i, si), fi, epsilon1<scalar_t>());
+                UTEST_CHECK_EQUAL(si.size(), function.ssize());
+                function.expand_i(i, si, 1, gs);
+                function.rgrad(x, gs);
+                UTEST_CHECK_EIGEN_CLOSE(gs, gi, epsilon1<scalar_t>());
+            }
+
+            // the directional derivative is consistent with the gradient
+            const vector_t d = vector_t::Random(function.size());
+            scalar_t fd = 0, dg = 0;
+            UTEST_REQUIRE(function.vdir(x, d, fd, dg));
+            UTEST_CHECK_CLOSE(fd, fx, epsilon1<scalar_t>());
+            UTEST_CHECK_CLOSE(dg, gx.dot(d), epsilon1<scalar_t>());
+
+            // the restriction to the line is consistent with the function value and the gradient
+            vector_t coeffs, gt;
+            UTEST_REQUIRE(function.line_coeffs(x, d, coeffs));
+            for (const auto t : {0.0, 0.3, 1.0})
+            {
+                scalar_t dphi = 0;
+                const auto ft = function.vgrad(x + t * d, &gt);
+                UTEST_CHECK_CLOSE(fx + function.line_vgrad(coeffs, t, dphi), ft, epsilon1<scalar_t>());
+                UTEST_CHECK_CLOSE(dphi, gt.dot(d), epsilon1<scalar_t>());
+            }
+
+            // shuffling changes only the order of the samples
+            function.shuffle();
+            UTEST_CHECK_CLOSE(function.vgrad(x), fx, epsilon1<scalar_t>());
+        }
+    }
+}
+
+UTEST_CASE(linear_function_invalid)
+{
+    auto dataset = synthetic_dataset_t{10, 2, 1, false};
+    UTEST_REQUIRE(dataset.load());
+
+    const auto loss = loss_t::all().get("squared");
+    UTEST_CHECK_THROW(linear_function_t(dataset, fold, *loss, -1.0), std::invalid_argument);
+}
+
+UTEST_CASE(config)
+{
+    for (const auto& solver_id : stoch_solver_t::all().ids())
+    {
+        const auto solver = stoch_solver_t::all().get(solver_id);
+        UTEST_REQUIRE(solver);
+
+        auto json = solver->config();
+        UTEST_CHECK_NOTHROW(solver->config(json));
+
+        json["max_epochs"] = "0";
+        UTEST_CHECK_THROW(solver->config(json), std::invalid_argument);
+    }
+}
+
+UTEST_CASE(minimize)
+{
+    auto dataset = synthetic_dataset_t{200, 4, 1, false};
+    UTEST_REQUIRE(dataset.load());
+
+    const auto loss = loss_t::all().get("squared");
+    auto function = linear_function_t{dataset, fold, *loss};
+
+    for (const auto& solver_id : stoch_solver_t::all().ids())
+    {
+        const auto solver = stoch_solver_t::all().get(solver_id);
+        UTEST_REQUIRE(solver);
+
+        auto json = solver->config();
+        json["lrate"] = solver_id == "adam" ? 1e-2 : 5e-2;
+        json["max_epochs"] = 200;
+        if (json.count("batch"))
+        {
+            json["batch"] = 10;
+        }
+        solver->config(json);
+
+        size_t epochs = 0;
+        solver->logger([&] (const solver_state_t& state)
+        {
+            UTEST_CHECK(std::isfinite(state.f));
+            ++ epochs;
+            return true;
+        });
+
+        const vector_t x0 = vector_t::Zero(function.size());
+        const auto f0 = function.vgrad(x0);
+        const auto state = solver->minimize(function, x0);
+
+        UTEST_CHECK(std::isfinite(state.f));
+        UTEST_CHECK_LESS(state.f, 1e-3 * f0);
+        UTEST_CHECK_EQUAL(epochs, state.m_iterations);
+        UTEST_CHECK_NOT_EQUAL(state.m_status, solver_state_t::status::failed);
+        UTEST_CHECK_GREATER_EQUAL(state.m_fcalls, state.m_iterations);
+    }
+}
+
+UTEST_CASE(minimize_variance_reduced)
+{
+    auto dataset = synthetic_dataset_t{200, 4, 1, false};
+    UTEST_REQUIRE(dataset.load());
+
+    const auto loss = loss_t::all().get("squared");
+    auto function = linear_function_t{dataset, fold, *loss, 1e-3};
+
+    // NB: the variance reduced solvers converge linearly with a constant learning rate
+    for (const auto& solver_id : {"svrg", "saga"})
+    {
+        const auto solver = stoch_solver_t::all().get(solver_id);
+        UTEST_REQUIRE(solver);
+
+        solver->lrate(5e-2);
+        solver->epsilon(1e-8);
+        solver->max_epochs(500);
+
+        const vector_t x0 = vector_t::Zero(function.size());
+        const auto state = solver->minimize(function, x0);
+
+        UTEST_CHECK_EQUAL(state.m_status, solver_state_t::status::converged);
+        UTEST_CHECK_LESS(state.convergence_criterion(), 1e-8);
+    }
+}
+
+UTEST_END_MODULE()
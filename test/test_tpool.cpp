@@ -1,3 +1,6 @@
+#include <array>
+#include <future>
+#include <functional>
 #include <numeric>
 #include <nano/arch.h>
 #include <nano/tpool.h>
@@ -7,6 +10,21 @@
 
 using namespace nano;
 
+#if defined(__GLIBC__)
+
+// NB: count the heap allocations of all threads (including the worker threads) by interposing malloc.
+extern "C" void* __libc_malloc(size_t);
+
+static std::atomic<size_t> n_mallocs{0};
+
+extern "C" void* malloc(size_t size)
+{
+    n_mallocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+#endif
+
 namespace
 {
     // single-threaded
@@ -112,10 +130,10 @@ UTEST_CASE(enqueue)
     std::mutex mutex;
     std::vector<size_t> tasks_done;
     {
-        tpool_section_t<future_t> futures;
+        tpool_section_t section(pool);
         for (size_t j = 0; j < tasks; ++ j)
         {
-            futures.push_back(pool.enqueue([=, &mutex, &tasks_done]()
+            section.enqueue([=, &mutex, &tasks_done]()
             {
                 const auto sleep1 = urand<size_t>(1, 5, make_rng());
                 std::this_thread::sleep_for(std::chrono::milliseconds(sleep1));
@@ -125,7 +143,7 @@ UTEST_CASE(enqueue)
 
                     tasks_done.push_back(j + 1);
                 }
-            }));
+            });
         }
     }
 
@@ -167,4 +185,480 @@ UTEST_CASE(loopr)
     }
 }
 
+UTEST_CASE(modes)
+{
+    const auto op = [] (const size_t i) { return std::sin(i); };
+
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        for (const size_t workers : {size_t(1), size_t(3), size_t(8)})
+        {
+            tpool_t pool(mode, workers);
+            UTEST_CHECK_EQUAL(pool.mode(), mode);
+            UTEST_CHECK_EQUAL(pool.workers(), workers);
+
+            for (size_t size = 1; size <= size_t(1024); size *= 4)
+            {
+                std::vector<double> results(size, -1);
+                nano::loopr(pool, size, size_t(3), [&] (const size_t begin, const size_t end, const size_t tnum)
+                {
+                    UTEST_CHECK_LESS(begin, end);
+                    UTEST_CHECK_LESS_EQUAL(end, size);
+                    UTEST_CHECK_LESS(tnum, workers);
+
+                    for (auto i = begin; i < end; ++ i)
+                    {
+                        results[i] = op(i);
+                    }
+                });
+
+                UTEST_CHECK_CLOSE(test_single(size, op), std::accumulate(results.begin(), results.end(), 0.0), epsilon1<double>());
+            }
+        }
+    }
+}
+
+UTEST_CASE(schedules)
+{
+    for (const auto schedule : enum_values<tpool_schedule>())
+    {
+        for (const size_t workers : {size_t(1), size_t(3), size_t(8)})
+        {
+            tpool_t pool(tpool_mode::work_stealing, workers);
+
+            for (size_t size = 1; size <= size_t(1024); size *= 4)
+            {
+                for (const size_t chunk : {size_t(1), size_t(3), size_t(16)})
+                {
+                    std::vector<size_t> visits(size, 0);
+                    nano::loopr(pool, size, chunk, [&] (const size_t begin, const size_t end, const size_t tnum)
+                    {
+                        UTEST_CHECK_LESS(begin, end);
+                        UTEST_CHECK_LESS_EQUAL(end, size);
+                        UTEST_CHECK_LESS_EQUAL(end - begin, chunk);
+                        UTEST_CHECK_LESS(tnum, workers);
+
+                        for (auto i = begin; i < end; ++ i)
+                        {
+                            ++ visits[i];
+                        }
+                    }, schedule);
+
+                    UTEST_CHECK(std::all_of(visits.begin(), visits.end(), [] (const size_t count) { return count == 1; }));
+                }
+            }
+        }
+    }
+}
+
+UTEST_CASE(parse_cpus)
+{
+    UTEST_CHECK_EQUAL(tpool_config_t::parse_cpus("").size(), 0U);
+    UTEST_CHECK(tpool_config_t::parse_cpus("3") == std::vector<size_t>({3}));
+    UTEST_CHECK(tpool_config_t::parse_cpus("0-3,8") == std::vector<size_t>({0, 1, 2, 3, 8}));
+    UTEST_CHECK(tpool_config_t::parse_cpus("8,2-3,3") == std::vector<size_t>({2, 3, 8}));
+
+    UTEST_CHECK_THROW(tpool_config_t::parse_cpus("a"), std::invalid_argument);
+    UTEST_CHECK_THROW(tpool_config_t::parse_cpus("1-"), std::invalid_argument);
+    UTEST_CHECK_THROW(tpool_config_t::parse_cpus("3-1"), std::invalid_argument);
+    UTEST_CHECK_THROW(tpool_config_t::parse_cpus("1x,2"), std::invalid_argument);
+}
+
+UTEST_CASE(affinity)
+{
+    const auto cpus = tpool_available_cpus();
+    UTEST_REQUIRE(!cpus.empty());
+
+    for (const size_t workers : {size_t(0), size_t(3)})
+    {
+        tpool_config_t config;
+        config.m_workers = workers;
+        config.m_affinity = true;
+        config.m_cpus = {cpus[0]};
+
+        tpool_t pool(config);
+        UTEST_CHECK_EQUAL(pool.workers(), workers == 0 ? size_t(1) : workers);
+
+        for (const auto schedule : enum_values<tpool_schedule>())
+        {
+            const auto value = nano::loop_reduce(pool, size_t(1000), size_t(7), size_t(0),
+                [&] (const size_t begin, const size_t end) { return (begin + end - 1) * (end - begin) / 2; },
+                std::plus<size_t>());
+            UTEST_CHECK_EQUAL(value, size_t(999 * 1000 / 2));
+
+            std::vector<size_t> visits(1000, 0);
+            nano::loopr(pool, size_t(1000), size_t(7), [&] (const size_t begin, const size_t end, const size_t)
+            {
+                for (auto i = begin; i < end; ++ i)
+                {
+                    ++ visits[i];
+                }
+            }, schedule);
+            UTEST_CHECK(std::all_of(visits.begin(), visits.end(), [] (const size_t count) { return count == 1; }));
+        }
+    }
+}
+
+UTEST_CASE(configure_after_use)
+{
+    tpool_t::instance();
+    UTEST_CHECK_THROW(tpool_t::configure(tpool_config_t{}), std::runtime_error);
+}
+
+UTEST_CASE(named_pools)
+{
+    tpool_config_t config;
+    config.m_workers = 3;
+    UTEST_CHECK_NOTHROW(tpool_t::configure("test-named-pool", config));
+
+    auto& pool = tpool_t::instance("test-named-pool");
+    UTEST_CHECK_EQUAL(pool.workers(), size_t(3));
+    UTEST_CHECK_EQUAL(&pool, &tpool_t::instance("test-named-pool"));
+    UTEST_CHECK_NOT_EQUAL(&pool, &tpool_t::instance());
+    UTEST_CHECK_NOT_EQUAL(&pool, &tpool_t::instance("test-other-pool"));
+    UTEST_CHECK_EQUAL(&tpool_t::instance(""), &tpool_t::instance());
+
+    UTEST_CHECK_THROW(tpool_t::configure("test-named-pool", config), std::runtime_error);
+
+    const auto op = [] (const size_t i) { return std::sin(i); };
+    std::vector<double> results(100, -1);
+    nano::loopi(pool, results.size(), [&] (const size_t i, const size_t tnum)
+    {
+        UTEST_CHECK_LESS(tnum, size_t(3));
+        results[i] = op(i);
+    });
+    UTEST_CHECK_CLOSE(test_single(results.size(), op), std::accumulate(results.begin(), results.end(), 0.0), epsilon1<double>());
+}
+
+UTEST_CASE(priorities)
+{
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        tpool_t pool(mode, 1);
+
+        // block the only worker to queue the tasks below
+        std::atomic<bool> started{false}, release{false};
+        pool.enqueue([&] ()
+        {
+            started = true;
+            while (!release)
+            {
+                std::this_thread::yield();
+            }
+        });
+        while (!started)
+        {
+            std::this_thread::yield();
+        }
+
+        std::mutex mutex;
+        std::vector<tpool_priority> order;
+        {
+            tpool_section_t normal_section(pool, tpool_priority::normal);
+            tpool_section_t high_section(pool, tpool_priority::high);
+            for (size_t i = 0; i < 8; ++ i)
+            {
+                normal_section.enqueue([&] ()
+                {
+                    const std::lock_guard<std::mutex> lock(mutex);
+                    order.push_back(tpool_priority::normal);
+                });
+            }
+            for (size_t i = 0; i < 8; ++ i)
+            {
+                high_section.enqueue([&] ()
+                {
+                    const std::lock_guard<std::mutex> lock(mutex);
+                    order.push_back(tpool_priority::high);
+                });
+            }
+
+            release = true;
+        }
+
+        UTEST_REQUIRE_EQUAL(order.size(), size_t(16));
+        UTEST_CHECK(std::all_of(order.begin(), order.begin() + 8, [] (const auto p) { return p == tpool_priority::high; }));
+        UTEST_CHECK(std::all_of(order.begin() + 8, order.end(), [] (const auto p) { return p == tpool_priority::normal; }));
+    }
+}
+
+UTEST_CASE(spin_and_hot_loop)
+{
+    const auto op = [] (const size_t i) { return std::cos(i); };
+
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        for (const size_t spin : {size_t(0), size_t(1024)})
+        {
+            tpool_config_t config;
+            config.m_mode = mode;
+            config.m_workers = 3;
+            config.m_spin = spin;
+
+            tpool_t pool(config);
+            for (const auto hot : {false, true})
+            {
+                std::unique_ptr<tpool_hot_loop_t> hot_loop;
+                if (hot)
+                {
+                    hot_loop = std::make_unique<tpool_hot_loop_t>(pool);
+                }
+
+                for (size_t trial = 0; trial < 100; ++ trial)
+                {
+                    const auto size = trial + 1;
+
+                    std::vector<double> results(size, -1);
+                    nano::loopi(pool, size, [&] (const size_t i, const size_t) { results[i] = op(i); });
+                    UTEST_CHECK_CLOSE(test_single(size, op), std::accumulate(results.begin(), results.end(), 0.0), epsilon1<double>());
+                }
+            }
+        }
+    }
+}
+
+UTEST_CASE(enqueue_from_workers)
+{
+    tpool_t pool(tpool_mode::work_stealing, 4);
+
+    const size_t outer_tasks = 16, inner_tasks = 64;
+
+    std::atomic<size_t> done{0};
+    {
+        tpool_section_t section(pool);
+        for (size_t i = 0; i < outer_tasks; ++ i)
+        {
+            section.enqueue([&] ()
+            {
+                // NB: these tasks are pushed into the deque of the worker thread and may be stolen by the others
+                for (size_t j = 0; j < inner_tasks; ++ j)
+                {
+                    pool.enqueue([&] () { done.fetch_add(1); });
+                }
+            });
+        }
+    }
+
+    // NB: the inner tasks are still processed after the outer ones are done!
+    while (done.load() < outer_tasks * inner_tasks)
+    {
+        std::this_thread::yield();
+    }
+
+    UTEST_CHECK_EQUAL(done.load(), outer_tasks * inner_tasks);
+}
+
+UTEST_CASE(nested_loops)
+{
+    const auto op = [] (const size_t i) { return std::sin(i); };
+
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        for (const size_t workers : {size_t(1), size_t(2), size_t(4)})
+        {
+            tpool_t pool(mode, workers);
+
+            // NB: all workers block in the outer loop waiting for the inner loops to finish!
+            const size_t outer_size = 17, inner_size = 129;
+
+            std::vector<double> results(outer_size, -1);
+            nano::loopi(pool, outer_size, [&] (const size_t i, const size_t)
+            {
+                std::vector<double> inner_results(inner_size, -1);
+                nano::loopr(pool, inner_size, size_t(5), [&] (const size_t begin, const size_t end, const size_t tnum)
+                {
+                    UTEST_CHECK_LESS(tnum, workers);
+                    for (auto j = begin; j < end; ++ j)
+                    {
+                        inner_results[j] = op(i * inner_size + j);
+                    }
+                });
+
+                results[i] = std::accumulate(inner_results.begin(), inner_results.end(), 0.0);
+            });
+
+            const auto ref = test_single(outer_size * inner_size, op);
+            UTEST_CHECK_CLOSE(ref, std::accumulate(results.begin(), results.end(), 0.0), epsilon1<double>());
+        }
+    }
+}
+
+UTEST_CASE(nested_sections_destructor_only)
+{
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        for (const size_t workers : {size_t(1), size_t(2), size_t(4)})
+        {
+            tpool_t pool(mode, workers);
+
+            const size_t outer_size = 64, inner_size = 7;
+
+            std::atomic<size_t> done{0};
+            nano::loopi(pool, outer_size, [&] (const size_t, const size_t)
+            {
+                for (size_t trial = 0; trial < 8; ++ trial)
+                {
+                    // NB: no explicit call to wait, the section (and its latch) is destroyed
+                    //  as soon as the last task counts down!
+                    tpool_section_t section(pool);
+                    for (size_t j = 0; j < inner_size; ++ j)
+                    {
+                        section.enqueue([&] () { done.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                }
+            });
+
+            UTEST_CHECK_EQUAL(done.load(), outer_size * 8 * inner_size);
+        }
+    }
+}
+
+UTEST_CASE(loop_reduce)
+{
+    const auto op = [] (const size_t i) { return std::sin(i); };
+    const auto map = [&] (const size_t begin, const size_t end)
+    {
+        double value = 0;
+        for (auto i = begin; i < end; ++ i)
+        {
+            value += op(i);
+        }
+        return value;
+    };
+
+    for (const auto reduction : enum_values<tpool_reduction>())
+    {
+        UTEST_CHECK_EQUAL(nano::loop_reduce(size_t(0), size_t(3), 42.0, map, std::plus<double>(), reduction), 42.0);
+
+        for (size_t size = 1; size <= size_t(4096); size *= 4)
+        {
+            const auto ref = test_single(size, op);
+
+            std::vector<double> values;
+            for (const size_t workers : {size_t(1), size_t(3), size_t(8)})
+            {
+                tpool_t pool(tpool_mode::work_stealing, workers);
+                for (const size_t chunk : {size_t(1), size_t(7), size_t(64)})
+                {
+                    const auto value = nano::loop_reduce(pool, size, chunk, 1.0, map, std::plus<double>(), reduction);
+                    UTEST_CHECK_CLOSE(ref + 1.0, value, epsilon1<double>());
+                    values.push_back(value);
+                }
+            }
+
+            // NB: the deterministic reduction must give exactly the same result for the same chunk size
+            if (reduction == tpool_reduction::deterministic)
+            {
+                for (size_t i = 3; i < values.size(); ++ i)
+                {
+                    UTEST_CHECK_EQUAL(values[i], values[i % 3]);
+                }
+            }
+        }
+    }
+}
+
+UTEST_CASE(section_large_tasks)
+{
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        tpool_t pool(mode, 3);
+
+        // NB: more tasks than preallocated and with callables larger than the inline buffer
+        const size_t tasks = 4096;
+        std::array<size_t, 32> payload;
+        std::iota(payload.begin(), payload.end(), size_t(1));
+        static_assert(sizeof(payload) > tpool_task_t::capacity, "");
+
+        std::atomic<size_t> sum{0};
+        {
+            tpool_section_t section(pool);
+            for (size_t i = 0; i < tasks; ++ i)
+            {
+                section.enqueue([payload, &sum] ()
+                {
+                    sum.fetch_add(std::accumulate(payload.begin(), payload.end(), size_t(0)));
+                });
+            }
+            section.wait();
+        }
+
+        UTEST_CHECK_EQUAL(sum.load(), tasks * 32 * 33 / 2);
+    }
+}
+
+UTEST_CASE(section_exception)
+{
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        tpool_t pool(mode, 3);
+
+        std::atomic<size_t> done{0};
+
+        tpool_section_t section(pool);
+        for (size_t i = 0; i < 32; ++ i)
+        {
+            section.enqueue([i, &done] ()
+            {
+                done.fetch_add(1);
+                if (i % 8 == 3)
+                {
+                    throw std::runtime_error("task failed");
+                }
+            });
+        }
+
+        UTEST_CHECK_THROW(section.wait(), std::runtime_error);
+        UTEST_CHECK_EQUAL(done.load(), size_t(32));
+        UTEST_CHECK_NOTHROW(section.wait());
+    }
+}
+
+#if defined(__GLIBC__)
+
+UTEST_CASE(no_allocations_while_looping)
+{
+    for (const auto mode : enum_values<tpool_mode>())
+    {
+        tpool_t pool(mode, 3);
+
+        std::vector<double> results(1000, 0.0);
+        const auto schedules = enum_values<tpool_schedule>();
+        const auto loops = [&] ()
+        {
+            for (size_t trial = 0; trial < 100; ++ trial)
+            {
+                nano::loopi(pool, results.size(), [&] (const size_t i, const size_t)
+                {
+                    results[i] += 1.0;
+                });
+
+                for (const auto schedule : schedules)
+                {
+                    nano::loopr(pool, results.size(), size_t(7), [&] (const size_t begin, const size_t end, const size_t)
+                    {
+                        for (auto i = begin; i < end; ++ i)
+                        {
+                            results[i] += 1.0;
+                        }
+                    }, schedule);
+                }
+            }
+        };
+
+        // NB: the first loops may grow the task queues...
+        loops();
+
+        // ... but then the steady state should perform no heap allocation
+        const auto old_n_mallocs = n_mallocs.load();
+        loops();
+        UTEST_CHECK_EQUAL(n_mallocs.load(), old_n_mallocs);
+
+        const auto expected = 2.0 * 100.0 * (1.0 + static_cast<double>(schedules.size()));
+        UTEST_CHECK(std::all_of(results.begin(), results.end(), [&] (const double value) { return value == expected; }));
+    }
+}
+
+#endif
+
 UTEST_END_MODULE()